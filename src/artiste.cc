@@ -3,16 +3,26 @@
 
 #include "hiptext/artiste.h"
 
+#include <algorithm>
+#include <chrono>
 #include <iostream>
+#include <limits>
+#include <sstream>
+#include <thread>
 #include <stdio.h>
 #include <signal.h>
 #include <sys/ioctl.h>
 #include <sys/termios.h>
 #include <sys/select.h>
+#include <unistd.h>
 #include <gflags/gflags.h>
 #include <glog/logging.h>
 
+#include "hiptext/framecache.h"
 #include "hiptext/movie.h"
+#include "hiptext/pixel.h"
+#include "hiptext/replaycache.h"
+#include "hiptext/summedarea.h"
 
 #ifdef __APPLE__
 using sighandler_t = sig_t;
@@ -24,21 +34,52 @@ using std::string;
 DEFINE_int32(width, 0, "Width of rendering. Defaults to 0, in which case it "
            "automatically detects the terminal width. If height is not "
            "provided, it still maintains the aspect ratio. Cannot exceed the "
-           "terminal width");
+           "terminal width, except in --png_out previews");
 DEFINE_int32(height, 0, "Height of rendering. Defaults to 0, in which case it "
            "automatically maintains the aspect ratio with respect to width");
 DEFINE_bool(equalize, false, "Use the histogram equalizer filter. You should "
             "use this when your image looks 'washed out' or grey when rendered "
             "in hiptext");
+DEFINE_string(scaler, "bilinear", "How images are resized to fit: bilinear, "
+              "or area, which averages every pixel that lands in each cell. "
+              "Area keeps fine detail from aliasing when shrinking big "
+              "images, and falls back to bilinear when enlarging");
+DEFINE_bool(linear, false, "Scale images in linear light rather than on "
+            "their sRGB codes. Blending codes directly makes fine bright "
+            "detail, like text or foliage against the sky, come out too dark "
+            "once shrunk");
 DEFINE_bool(stepthrough, false, "Whether to wait for human to press Return "
             "between frames. Only applicable to movie playbacks");
+DEFINE_bool(loop, false, "Play movies over and over until Ctrl-C is pressed. "
+            "The output of the first pass is remembered and replayed with its "
+            "original timing, so later loops cost almost no CPU");
+DEFINE_int32(loop_cache, 64, "Megabytes of rendered output to remember for "
+             "replaying loops of movies and animated images. Loops that don't "
+             "fit get rendered from scratch each time");
+
+DECLARE_string(bg);
+DECLARE_string(png_out);
+
+// Browsers consider animation frame delays this small to be bogus.
+static const double kMinimumDelay = 0.02;
+static const double kDefaultDelay = 0.1;
+
+static const char kResetCursor[] = "\x1b[H";  // ANSI put cursor in top left.
 
 static volatile bool g_done = false;
+static bool g_playing = false;
+static int g_cell_width = 0;  // From SetCellSize(), if nonzero.
+static int g_cell_height = 0;
 
 static void OnCtrlC(int /*signal*/) {
   g_done = true;
 }
 
+inline std::chrono::steady_clock::duration Seconds(double seconds) {
+  return std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+      std::chrono::duration<double>(seconds));
+}
+
 inline double RatioOf(int width, int height) {
   return static_cast<double>(width) / static_cast<double>(height);
 }
@@ -96,20 +137,66 @@ getpixelsize(std::ostream& out, std::istream& in, int *pwidth, int *pheight) {
   }
 }
 
+bool IsPlayingVideo() {
+  return g_playing;
+}
+
+void SetPlayingVideo(bool playing) {
+  g_playing = playing;
+}
+
+bool HasLightBackground() {
+  return Pixel(FLAGS_bg).grey() > 0.5;
+}
+
+void SetCellSize(int width, int height) {
+  g_cell_width = width;
+  g_cell_height = height;
+}
+
+bool GetCellSize(int* width, int* height) {
+  if (g_cell_width && g_cell_height) {
+    *width = g_cell_width;
+    *height = g_cell_height;
+    return true;
+  }
+  winsize ws;
+  if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws) != 0 ||
+      !ws.ws_col || !ws.ws_row || !ws.ws_xpixel || !ws.ws_ypixel) {
+    return false;
+  }
+  *width = ws.ws_xpixel / ws.ws_col;
+  *height = ws.ws_ypixel / ws.ws_row;
+  return *width > 0 && *height > 0;
+}
+
 Artiste::Artiste(std::ostream& output,
                  std::istream& input,
                  RenderAlgorithm algorithm,
-                 bool duo_pixel,
-                 bool use_sixel)
-    : output_(output), algorithm_(algorithm), duo_pixel_(duo_pixel) {
+                 int cell_width,
+                 int cell_height,
+                 bool pixel_mode)
+    : output_(output), algorithm_(algorithm), cell_width_(cell_width),
+      cell_height_(cell_height) {
+  // A --png_out preview shouldn't depend on the terminal it was made in.
   winsize ws;
-  PCHECK(ioctl(0, TIOCGWINSZ, &ws) == 0);
+  if (!FLAGS_png_out.empty() || ioctl(0, TIOCGWINSZ, &ws) != 0 ||
+      !ws.ws_col || !ws.ws_row) {
+    ws.ws_col = 80;
+    ws.ws_row = 24;
+  }
   // Users' concept of a "pixel" shall be as square as possible.
   // Therefore, double ws_row since characters approximate ~2:1rectangles.
   term_height_ = ws.ws_row * 2;
   term_width_ = ws.ws_col;
+  if (!FLAGS_png_out.empty() && (FLAGS_width || FLAGS_height)) {
+    // No screen to fit, so whichever is given decides the size alone.
+    term_width_ = FLAGS_width ? FLAGS_width : std::numeric_limits<int>::max();
+    term_height_ = (FLAGS_height ? FLAGS_height :
+                    std::numeric_limits<int>::max());
+  }
 
-  if (use_sixel)
+  if (pixel_mode)
     getpixelsize(output, input, &term_width_, &term_height_);
 
   // If user provides *both* FLAGS_width and FLAGS_height, remember their
@@ -140,15 +227,16 @@ void Artiste::ComputeDimensions(double media_ratio) {
   // Apply ratio both ways to ensure a fit.
   height = std::min(height, width / true_ratio_);
   width = std::min(width, height * true_ratio_);
-  width_ = static_cast<int>(width);
-  height_ = static_cast<int>(height) / (duo_pixel_ ? 1 : 2);
+  // Each character cell is one unit wide and two tall.
+  width_ = static_cast<int>(width) * cell_width_;
+  height_ = static_cast<int>(height) * cell_height_ / 2;
 
   LOG(INFO) << "Terminal Resolution: " << term_width_ << "x" << term_height_;
   LOG(INFO) << "Final Resolution (pixel-agnostic): " << width_ << "x"
             << height_;
 }
 
-void Artiste::PrintImage(Graphic graphic) {
+Graphic Artiste::Prepare(Graphic graphic) {
   // Image decoders biject 1:1 to Hiptext's raw RGB representation,
   // so must be scaled once more prior to rendering.
   ComputeDimensions(RatioOf(graphic.width(), graphic.height()));
@@ -157,7 +245,59 @@ void Artiste::PrintImage(Graphic graphic) {
     graphic.Equalize();
     // graphic.FromYUV();
   }
-  algorithm_(output_, graphic.BilinearScale(width_, height_));
+  Pixel bg(FLAGS_bg);
+  if (FLAGS_linear) {
+    graphic.ToLinear();
+    bg.ToLinear();
+  }
+  // Scaling premultiplied colors keeps invisible pixels from tinting the
+  // edges of visible ones. Opaque images skip the work.
+  graphic.Premultiply();
+  Graphic res = Scale(graphic);
+  if (opacify_) {
+    res.Opacify(bg);
+  } else {
+    res.Unpremultiply();
+  }
+  if (FLAGS_linear) {
+    res.FromLinear();
+  }
+  return res;
+}
+
+Graphic Artiste::Scale(const Graphic& graphic) const {
+  if (FLAGS_scaler == "area") {
+    if (width_ <= graphic.width() && height_ <= graphic.height()) {
+      return AreaScale(graphic, width_, height_);
+    }
+  } else if (FLAGS_scaler != "bilinear") {
+    LOG(FATAL) << "Unknown --scaler: " << FLAGS_scaler;
+  }
+  return graphic.BilinearScale(width_, height_);
+}
+
+void Artiste::PrintImage(Graphic graphic) {
+  algorithm_(output_, Prepare(std::move(graphic)));
+}
+
+string Artiste::RenderImage(Graphic graphic) {
+  std::ostringstream out;
+  algorithm_(out, Prepare(std::move(graphic)));
+  return out.str();
+}
+
+void Artiste::RepaintImage(Graphic graphic) {
+  string bytes = RenderImage(std::move(graphic));
+  if (repaint_lines_ > 0) {
+    output_ << "\r\x1b[" << repaint_lines_ << "A";  // ANSI cursor up.
+  } else if (repaint_lines_ == 0) {
+    output_ << "\x1b" "8";  // DEC restore cursor, for output without newlines.
+  } else {
+    output_ << "\x1b" "7";  // DEC save cursor.
+  }
+  repaint_lines_ = std::count(bytes.begin(), bytes.end(), '\n');
+  output_.write(bytes.data(), bytes.size());
+  output_.flush();
 }
 
 void Artiste::PrintMovie(Movie movie) {
@@ -166,27 +306,126 @@ void Artiste::PrintMovie(Movie movie) {
   ComputeDimensions(RatioOf(movie.width(), movie.height()));
   movie.PrepareRGB(width_, height_);
   HideCursor();
+  SetPlayingVideo(true);
   sighandler_t old_handler = signal(SIGINT, OnCtrlC);
-  for (auto graphic : movie) {
-    if (g_done) {
+  Graphic first(0, 0);
+  auto play = [&](ReplayCache* replay) {
+    for (auto graphic : movie) {
+      if (g_done || movie.done()) {
+        break;
+      }
+      if (FLAGS_equalize) {
+        // graphic.ToYUV();
+        graphic.Equalize();
+        // graphic.FromYUV();
+      }
+      if (replay && !first.width()) {
+        first = graphic;
+      }
+      double delay = movie.delay();
+      PrintFrame(graphic, (delay > 0) ? delay : kDefaultDelay, replay);
+      if (FLAGS_stepthrough) {
+        string lulz;
+        std::getline(std::cin, lulz);
+      }
+    }
+  };
+  if (FLAGS_loop) {
+    ReplayCache replay(static_cast<size_t>(FLAGS_loop_cache) << 20);
+    play(replayable_ ? &replay : nullptr);
+    if (replay.ok()) {
+      replay.Finish(RenderFrame(first));
+    }
+    while (!g_done) {
+      if (replay.ok()) {
+        replay.Play(output_, &g_done);
+      } else {
+        movie.Rewind();
+        play(nullptr);
+      }
+    }
+  } else {
+    play(nullptr);
+  }
+  signal(SIGINT, old_handler);
+  SetPlayingVideo(false);
+  ShowCursor();
+}
+
+void Artiste::PrintAnimation(Movie movie) {
+  // Animated images are short and meant to loop forever, so decode them just
+  // once at the final resolution and play them back from memory.
+  ComputeDimensions(RatioOf(movie.width(), movie.height()));
+  movie.PrepareRGB(width_, height_);
+  FrameCache frames;
+  for (;;) {
+    Graphic graphic = movie.Next();
+    if (movie.done()) {
       break;
     }
-    ResetCursor();
     if (FLAGS_equalize) {
-      // graphic.ToYUV();
       graphic.Equalize();
-      // graphic.FromYUV();
     }
-    algorithm_(output_, std::move(graphic));
-    if (FLAGS_stepthrough) {
-      string lulz;
-      std::getline(std::cin, lulz);
+    double delay = movie.delay();
+    frames.Add(graphic, (delay < kMinimumDelay) ? kDefaultDelay : delay);
+  }
+  CHECK_GT(frames.size(), 0) << "No frames could be decoded.";
+  if (frames.size() == 1) {
+    algorithm_(output_, frames.Get(0));
+    return;
+  }
+  LOG(INFO) << "Cached " << frames.size() << " frames in " << frames.bytes()
+            << " bytes.";
+  HideCursor();
+  SetPlayingVideo(true);
+  sighandler_t old_handler = signal(SIGINT, OnCtrlC);
+  auto play = [&](ReplayCache* replay) {
+    auto deadline = std::chrono::steady_clock::now();
+    for (int n = 0; n < frames.size() && !g_done; ++n) {
+      PrintFrame(frames.Get(n), frames.delay(n), replay);
+      deadline += Seconds(frames.delay(n));
+      std::this_thread::sleep_until(deadline);
+    }
+  };
+  // Once the first loop has been rendered, the rest are just write() calls.
+  ReplayCache replay(static_cast<size_t>(FLAGS_loop_cache) << 20);
+  play(replayable_ ? &replay : nullptr);
+  if (replay.ok()) {
+    replay.Finish(RenderFrame(frames.Get(0)));
+  }
+  while (!g_done) {
+    if (replay.ok()) {
+      replay.Play(output_, &g_done);
+    } else {
+      play(nullptr);
     }
   }
   signal(SIGINT, old_handler);
+  SetPlayingVideo(false);
   ShowCursor();
 }
 
+void Artiste::PrintFrame(const Graphic& graphic, double delay,
+                         ReplayCache* replay) {
+  if (!replay || !replay->recording()) {
+    ResetCursor();
+    algorithm_(output_, graphic);
+    output_.flush();
+    return;
+  }
+  string bytes = RenderFrame(graphic);
+  output_.write(bytes.data(), bytes.size());
+  output_.flush();
+  replay->Record(std::move(bytes), delay);
+}
+
+string Artiste::RenderFrame(const Graphic& graphic) {
+  std::ostringstream frame;
+  frame << kResetCursor;
+  algorithm_(frame, graphic);
+  return frame.str();
+}
+
 void Artiste::GenerateSpectrum() {
   int width = term_width_;
   int height = term_height_ * 2 - 2;
@@ -248,7 +487,7 @@ void Artiste::ShowCursor() {
 }
 
 void Artiste::ResetCursor() {
-  output_ << "\x1b[H";     // ANSI put cursor in top left.
+  output_ << kResetCursor;
 }
 
 // For Emacs:
@@ -0,0 +1,532 @@
+// hiptext - Image to Text Converter
+// By Justine Tunney
+
+#include "hiptext/bluenoise.h"
+
+// Made with MakeBlueNoise() in test/dither_test.cc, which checks it still
+// matches.
+const uint16_t g_blue_noise[64][64] = {
+  {  540, 2695, 1282, 3824, 2845,  349, 3046, 1997,
+    1583, 3832, 2963,  143,  983, 4059, 2270, 1739,
+    2481, 1168, 2179, 3675, 3273, 2837,  763, 3774,
+      76, 2353,  720, 2689,  463, 3818,  897, 1499,
+    2985, 4063, 1735, 1162, 3908, 1831, 1104, 2423,
+    3013, 1799, 3422, 2608, 1657, 1990, 3103,  963,
+    2158,  701, 1386,  465,  924, 2638, 2210, 3750,
+     263, 1151, 2972, 1576, 3770,  369, 3596, 2293 },
+  { 3947, 1634,  220, 3174, 1912, 1447, 3710,  688,
+    2425,  427, 1836, 3462, 2655,  477, 1269, 3772,
+     877, 3506, 1600,  558, 1016, 1490, 1989, 1164,
+    3015, 3679, 1906, 3504, 3143, 1314, 2462, 3618,
+    1931,  692, 2490,  210, 2290,  493, 3343,  113,
+    3642,  620, 2314, 1095,  770, 3771, 1442, 2513,
+    1766, 2987, 3535, 2014, 3140,   23, 1230,  769,
+    2437, 3505,  530, 2313, 1006, 3206, 1777, 1119 },
+  { 2944, 3391, 2121,  617, 1094, 2274, 2680, 1239,
+    3510, 2804, 1097, 2191, 1506, 3347, 2984,   91,
+    2768,  398, 3105, 2607, 3869,  238, 3429, 2554,
+     492,  984, 1436,  200, 2098,  584, 2885,  148,
+    1062, 2801, 1397, 3532, 2981, 1492, 2707, 2092,
+    1361, 2861,  264, 3899, 2965,  180, 3411,  498,
+    3960,  105, 2445, 1091, 4066, 1691, 3330, 2793,
+    1953, 1412, 4020, 1895, 2816,  648, 2532,   22 },
+  { 1380,  826, 2434, 4009, 3518,  409, 3319,   10,
+    2110,  782, 3992,  208, 2459,  681, 1854, 2153,
+    1479, 4006, 1937, 1296, 2278, 2956, 1713, 4012,
+    2212, 2893, 3345, 2589, 1086, 4005, 1579, 2220,
+    3237, 3834,  544, 2047,  999, 3730,  727, 4013,
+     972, 1741, 3482, 2064, 1212, 2294, 2729, 1319,
+     859, 3295, 1546,  324, 2756, 2161,  568, 3885,
+     330, 3135,  890,  145, 3413, 1445, 3854, 1999 },
+  { 3614, 2795,  322, 1516, 2879,  837, 1797, 3886,
+    1529, 3002, 1733, 3213, 1220, 3858, 3544,  951,
+    3258, 2408,  732,   48, 3602,  894,  564, 1250,
+     122, 1655,  700, 3633, 1760, 3080,  820, 3576,
+     303, 1683, 2624, 3173,    5, 1845, 2410,  299,
+    3203, 2636,  456, 1521, 3241,  566, 1789, 3736,
+    2203, 2673, 1900, 3769,  747, 1330, 3567, 1604,
+    1075, 2188, 2631, 3629, 1136, 2142, 3120,  488 },
+  { 1157, 1770, 3270, 2034, 1263, 2576, 3177, 1042,
+    2510,  313, 3701,  561, 2757, 1658,  274, 2622,
+     509, 1179, 3405, 1664, 2778, 2102, 3329, 2477,
+    3191, 3823, 2138,  416, 2377,   35, 2740, 1892,
+    1248, 2370,  860, 3978, 1289, 3423, 2875, 1561,
+    2016, 3726,  863, 2466, 4034,  944, 2939,  156,
+    3163, 1117,  447, 3403, 2962, 2399,  211, 2577,
+    2992, 3752,  604, 1542, 2394,  243,  906, 2658 },
+  { 2311,   98, 3863,  667, 3661,  173, 2238,  583,
+    3425, 1320, 2227, 1932,  985, 3114, 2195, 1407,
+    3798, 2960, 2015, 3911,  389, 1126, 3777, 1926,
+    1419,  929, 2851, 1190, 3874, 1456, 3448,  536,
+    3744, 3003,  397, 1610, 2271,  552, 1135, 3597,
+     623, 1281, 3030,   87, 1916, 3520, 1370, 2063,
+     662, 4011, 1443, 2100, 1023, 1791, 3231,  802,
+    2011,   49, 1800, 3292, 2791, 3720, 1862, 3987 },
+  { 1539, 3063, 1032, 2421, 2915, 1614, 4052, 1903,
+    2848,  821, 2679, 3458,  187, 4087,  759, 2814,
+    1802,  147,  930, 2595, 1471, 2932,  244,  729,
+    2686,  189, 3553, 1949, 3224,  868, 2117, 2570,
+     982, 2028, 3395, 2764, 3697, 1935, 3095,  179,
+    2587, 2226, 3815, 1608, 2802,  390, 2549, 3349,
+    1706, 2506, 2854,   63, 3646,  549, 3976, 1460,
+    3444, 1216, 4046,  838,  423, 1260, 3202,  677 },
+  { 3526, 2542, 1970,  461, 1160, 3229,  387, 1388,
+    3599,   79, 3929, 1446, 2435, 1192, 3396,  445,
+    3605, 2303, 3208,  548, 2167, 3630, 1738, 3113,
+    4072, 2276, 1595,  591, 2449,  257, 3069, 1367,
+    4083,   88, 1432,  793,  235, 2498,  902, 4088,
+    1786, 3353,  366, 1070, 2269,  783, 3887, 1020,
+     292, 3613,  841, 2340, 3087, 1167, 2693, 2245,
+     437, 2447, 2736, 2080, 3008, 1723, 2246,  219 },
+  { 1331,  832, 3747, 1702, 3480, 2177,  887, 2368,
+    3127, 1150, 1825,  645, 2979, 2075, 1675, 2535,
+    1099, 1577, 4029, 1277, 3430,  856, 2463, 1176,
+     400, 3414, 1000, 2971, 3955, 1670, 3577,  415,
+    1807, 3230, 2428, 3860, 1195, 3256, 1532, 2831,
+    1228,  771, 2046, 3236, 3659, 2968, 1431, 2133,
+    3026, 1264, 1886, 3857, 1585, 2024,  181, 3692,
+     993, 3147, 1427,  287, 3849,  991, 3421, 2753 },
+  { 4076,  370, 3133, 2618,   27, 1470, 3786, 2742,
+     340, 2079, 2611, 3315,  418, 3756,   26, 3083,
+     789, 2874,  271, 1871, 2748,   21, 3895, 2122,
+    1476, 2634, 1879,   70, 1235, 2692, 1037, 2850,
+    2283,  611, 2926, 1647, 2178, 3644,  425, 2325,
+      54, 3880, 2620, 1298,  582, 1794,    4, 3489,
+    2381,  562, 3214,  239,  762, 3538, 3020, 1538,
+    1876, 3894,  695, 3375, 1602, 2412,  563, 1889 },
+  { 2961, 1547, 2096,  752, 3926, 2948,  560, 1625,
+    3649,  835, 3862, 1519, 1028, 2362, 1373, 3896,
+    2054, 3673,  651, 2386, 3149, 1646,  603, 3023,
+    3721,  744, 3128, 3682, 2319, 2018,  680, 3762,
+    1275, 3490,  967,  293, 2704,  707, 1988, 3017,
+    3512, 1624, 2936,  246, 2491, 4054, 2734,  743,
+    1632, 3973, 2623, 1376, 2844, 2304,  497,  852,
+    2659,  138, 2302, 1125, 2667,   40, 3585,  914 },
+  { 2489,  158, 3397, 1257, 2384, 1039, 1928, 3392,
+    1197, 2317,  120, 2899, 3564, 1907, 3267,  514,
+    1731, 2569, 3355, 1215,  905, 3531, 1985, 1088,
+     216, 2218, 1353,  559, 3438,  297, 3102, 1590,
+     139, 2078, 3998, 1877, 3388, 1084, 3954, 1326,
+     517,  952, 1944, 3401, 1518,  997, 1995, 3109,
+    1174,  328, 2090, 3394, 1813, 1101, 4077, 3247,
+    2105, 3609, 3053, 1828, 3789, 3122, 1396, 2204 },
+  { 1130, 3724, 1843, 2752,  411, 3196, 2230,  218,
+    2656, 3181, 1796,  703, 2561,  231,  917, 2776,
+    1131,  119, 1513, 2108, 3764,  295, 2536, 2806,
+    3354, 1666, 4028, 2827, 1730,  923, 3962, 2379,
+    2760, 3178,  534, 1346, 3061,  107, 2550, 1822,
+    3301, 2352, 3748,  723, 2197, 3509,  452, 3802,
+    2473, 3598,  987,  586, 3683,   20, 2442, 1682,
+    1199,  545, 1462,  827,  374, 2050,  673, 3912 },
+  {  438, 3042,  627, 3519, 1671, 3985,  808, 3737,
+    1454,  485, 3943, 2205, 1229, 3055, 4078, 2259,
+    3610, 3010, 3942,  439, 2864, 1598, 1265, 3853,
+     846, 2395,  319, 1143, 2517, 3313, 1339, 1905,
+     781, 1145, 2530, 3718, 2300, 1660, 3638,  790,
+    2792,  342, 1225, 3075,  203, 2871, 1374, 1783,
+     100, 2922, 1694, 3092, 2585, 1359, 2969,  338,
+    3418, 2781, 3953, 2504, 2918, 3511, 1692, 2681 },
+  { 1987, 1511,  976, 2183,  321, 1356, 2524, 1778,
+    2991, 1046, 3293, 1575, 3643,  474, 1698, 1347,
+     632, 1913,  864, 2306, 3278,  696, 2182,  106,
+    1897, 3059,  668, 3479, 2044,   19, 2977,  443,
+    3814, 3342, 1762,  331,  884, 2856,  385, 2131,
+    1459, 4027, 2590, 1654, 3892, 2451,  866, 3350,
+    2165, 1322,  413, 2207, 3898,  907, 2033, 3829,
+     758, 1888,   89, 2200,  954, 1300,  137, 3332 },
+  { 2876, 3875, 2440, 3125, 3671, 2830,  128, 3481,
+     674, 2119,  240, 2799,  867, 2031, 3398, 2648,
+     250, 3469, 2745, 1144, 1761, 4067, 2940, 3459,
+    1384, 3705, 2684, 1457, 3931,  751, 2186, 3563,
+    1566,  124, 2162, 3012, 1500, 3916, 1206, 3449,
+    3098,   92, 1924,  569, 1073, 2007, 3652,  661,
+    2632, 4043, 3259,  717, 1569,  391, 3340, 1505,
+    2571, 1134, 3715, 1564, 3085, 4014, 2326,  861 },
+  {  377, 1249,   11, 1630,  872, 2019, 1186, 2339,
+    4025, 2687, 1290, 3840, 2436,    2, 2945,  981,
+    2358, 1578, 3799,   53, 2591,  336, 1002, 2483,
+     506,  932, 2229,  288, 1763, 2767, 1246, 2439,
+     941, 2709, 4042,  678, 3327, 2026, 2502,  602,
+    1014, 2291, 3622, 3194, 2782,  140, 1588, 3100,
+     273, 1059, 1812, 2407, 3521, 2858, 2328,  178,
+    3118, 2136, 3316,  690,  268, 2640, 1835, 3579 },
+  { 2146, 3296, 2700, 4007,  535, 3406, 2921,  464,
+    1525, 1873, 3379,  575, 1750, 3540, 1474, 3979,
+    3111,  750, 2037, 3325, 1410, 3632, 1974, 1552,
+    3260, 1859, 3833, 3152, 1018, 3645, 3280,  588,
+    3107, 1911, 1292, 2458, 1079,   47, 1640, 3716,
+    2912, 1567,  748, 1313, 3399, 2331, 3938, 1291,
+    2032, 2881, 3776,   80, 1012, 1767, 1240, 3681,
+     946,  470, 2829, 1717, 3472, 1139,  556, 1433 },
+  { 3725,  761, 1950, 1166, 2572, 1721, 3804,  912,
+    3062,   93,  996, 2215, 2834, 1175,  614, 2135,
+     372, 1270, 2808,  542, 2209, 3117,  434, 3928,
+    2807,   62, 1276, 2452,  529, 1998,  182, 1689,
+    3790,  258, 3419,  491, 3760, 3167, 2669,  325,
+    1959, 3806, 2711,  301, 1759,  922,  550, 2543,
+    3456,  760, 1434, 2594, 3112, 3964,  616, 2726,
+    1878, 4079, 1318, 2427, 2038, 3805, 3154, 2500 },
+  { 1714, 2842,  286, 3240, 2216,  199, 1401, 2279,
+    3560, 2501, 3793, 3180,  269, 3888, 2600, 1676,
+    3415, 3688, 1817, 4001, 1098,  774, 2560, 1172,
+    2282,  825, 3527, 3014, 1488, 4089, 2373, 2886,
+    1106, 2249, 2815, 1439, 1818, 2213,  882, 3434,
+    1232,  484, 2443, 4095, 2067, 3566, 2947, 1681,
+     345, 2285, 3617,  528, 2065,  266, 2247, 3435,
+    1475,   56, 3555,  822,  305, 2900,  931,  101 },
+  { 1108, 3517, 1533, 3839,  708, 2783, 3192,  396,
+    1962,  698, 1601, 1302, 2003,  842, 3221,  117,
+    2295,  959,  306, 2413, 2925, 1696, 3507,  346,
+    3324, 1652, 2061,  242, 2645,  785, 1311, 3546,
+     693, 1636, 3968,  804, 3029,  197, 3893, 1508,
+    2156, 3314, 1061, 1437, 2810,   39, 1241, 3837,
+    1034, 3072, 1829, 1209, 3370, 1639, 2950,  814,
+    2540, 2170, 3183, 2702, 1261, 1631, 2310, 4048 },
+  { 1910,  589, 2460, 1057, 2008, 3603,  973, 4068,
+    1204, 2744, 3393,  481, 2980, 2391, 3665, 1385,
+    3034, 2701, 1556, 3299,   73, 3719, 2070, 1453,
+    2949, 4000,  598, 3717, 1842, 3331, 2140,  111,
+    3153, 2584,  355, 2115, 3616, 1146, 2406, 2897,
+     713, 3033,  185, 3499,  768, 2382, 3216, 2002,
+    2614,  227, 4064, 2769,  892, 3784, 1343,  384,
+    3922, 1080,  610, 1896, 3902, 3387,  449, 3050 },
+  { 2621, 3352,  320, 3038, 1637,   52, 2518, 1775,
+    2994,  233, 2164, 3966, 1746, 1090,  644, 1899,
+     473, 3787,  734, 1967, 1310,  654, 2710,  968,
+     134, 2519,  937, 2822, 1163,  441, 2739, 3925,
+    1890, 1029, 3312, 1365, 2727,  581, 1711,  363,
+    3984, 1846, 2307, 1616, 3775, 1816,  467,  815,
+    3590, 1534,  697, 2236,   34, 2418, 3274, 2001,
+    2765, 1697, 3685,  149, 2448,  738, 2106, 1398 },
+  { 3871,  910, 2176, 3974, 1196, 3289, 2208,  539,
+    1496, 3525, 1026, 2598,   43, 3513, 2818, 4058,
+    2180, 1120, 3487, 2558, 3941, 2345, 3219, 3797,
+    1909, 1349, 2255, 3182, 1628, 3558,  873, 1424,
+     573, 2284, 3761,   38, 1956, 3184, 3530, 2537,
+    1223, 3443,  953, 2666,  291, 2958, 3997, 1392,
+    2334, 2929, 3465, 1667, 3164, 1069,  599, 3592,
+     229, 3121, 1323, 2857, 3249, 1052, 3669,  214 },
+  { 1234, 1771, 2888,  643, 2676, 3743,  831, 3116,
+    3907, 1984,  730, 3151, 1528, 2263, 1316,  204,
+    3250, 1722,  300, 3056, 1054,  188, 1611,  403,
+    3036, 3483,  410, 3952,    1, 2000, 2392, 3064,
+    3495, 1596, 2643,  766, 4050, 1438,  871, 2084,
+      68, 2835,  572, 3232, 1355, 1036, 2103, 3326,
+     176, 1161,  446, 2053, 3906, 2688, 1868, 1487,
+    2367,  786, 2123,  522, 1517, 1826, 2360, 3000 },
+  { 2058,  104, 3611, 1568,  280, 1875, 1371, 2633,
+     115, 1173, 2426, 3830,  356, 3356,  913, 2629,
+    1464, 2903, 2299,  606, 1852, 3439, 2224, 1203,
+    2582,  709, 2086, 1455, 2610, 3780, 1140,  202,
+    2787,  378, 1202, 3016, 2349,  276, 2789, 3695,
+    1512, 3831, 1784, 2185, 3529, 2522,  621, 2754,
+    1857, 3846, 2526,  792, 1321,  196, 3022, 4047,
+    1147, 3304, 3738, 2605, 4019,  358, 3457,  694 },
+  { 3781, 3279, 2512,  948, 2289, 3442,  466, 2144,
+    3367, 2892, 1699,  597, 2716, 1872, 3782,  515,
+    3623,  855, 3993, 1334, 3707, 2732,  787, 4056,
+    1719, 3655, 1087, 3052,  830,  532, 3305, 1748,
+    4002, 2087, 3674, 1772, 1043, 3360, 1866,  595,
+    3099, 2419,  921,  435, 3937,   85, 1626, 3723,
+     901, 3073, 1502, 3628, 3348, 2272,  904,  353,
+    2564, 1645,   77, 1893,  918, 2937, 1435, 2671 },
+  { 1656,  482, 1360, 3129, 4051, 2859, 1064, 3795,
+    1468,  430, 3588, 2130, 1074, 2978, 1586, 2083,
+    2455,   18, 1968, 2541,  285, 1503, 3144,  487,
+    2914,  144, 2336, 3402, 1867, 2759, 2231, 1381,
+     862, 2508,  647, 3235,  404, 3918, 1306, 2237,
+    1077,  251, 3376, 1481, 2908, 1971, 3161, 1293,
+     408, 2214,  110, 2813,  516, 1726, 3768, 1994,
+    3436,  660, 2970, 1243, 3594, 2088,  236, 1047 },
+  { 3037, 2268,  772, 1978,    3, 1672,  691, 2485,
+    1938,  934, 3039, 1368, 4041,  133,  725, 3238,
+    1158, 3074, 3523, 1001, 3310, 2118, 1105, 2469,
+    1945, 1405, 3897,  327, 1565, 3620,  262, 2930,
+    3366,   86, 1573, 2840, 2129, 2580,  131, 3657,
+    2703, 4069, 1919, 2494, 1112,  741, 2364, 3515,
+    2616, 4091, 1659, 1035, 2420, 3200, 1382, 2749,
+    1056, 2171, 3948, 2388,  580, 3291, 2476, 3990 },
+  {  159, 3676, 2785, 3410, 1226, 2647, 3551, 3148,
+     195, 3859, 2563,  311, 2337, 3468, 2555, 3930,
+     388, 1418, 1736,  622, 2762, 3932,   67, 3635,
+    3243,  641, 2803,  989, 2523,  715, 3825, 1085,
+    2012, 3905, 1222, 3634,  807, 1477, 3165, 1693,
+     629, 1278, 3041,  547, 3876, 3437,  241, 1004,
+    1883,  593, 3307, 2048, 3934,  736,    9, 3542,
+     394, 3097, 1400,  275, 2800, 1587,  753, 1918 },
+  { 1383,  986, 1734,  364, 3872, 2150,  401, 1345,
+    2281, 1737, 3282,  828, 1930, 1498,  979, 1792,
+    2202, 2931, 3826, 2348,  367, 1860, 1582,  829,
+    1251, 2267, 3534, 2005, 3212, 1352, 1840, 2429,
+     543, 3093, 2652, 1855,  499, 3451,  957, 2411,
+    3501, 2101,   66, 1673, 2741, 2074, 1572, 2967,
+    3651, 1403, 2891,  304, 1244, 3045, 2539, 1615,
+    1955, 3650,  858, 1833, 3855, 1171, 3524, 2737 },
+  { 3838, 3294, 2559,  722, 3001, 1593,  895, 4017,
+    2894, 1132,  555, 3751, 2772, 3096,  521, 3706,
+    2660,  168,  878, 3266, 1191, 3554, 3025, 2565,
+    3981,  215, 1650,  518, 4084,   55, 2843, 3484,
+    1607,  942,  217, 2347, 4016, 2938, 1979,  339,
+    2855,  840, 3209, 3690, 1336,  343, 3298, 2251,
+      46,  883, 2450, 3689, 1814, 2222,  964, 3879,
+     684, 2453, 2890, 3389, 2298,   59, 2095,  527 },
+  { 2332,  289, 2120, 3653, 1107, 2457, 3285, 1965,
+      78, 3573, 1629, 2141, 1201,   96, 3364, 1279,
+     712, 3440, 1379, 2013, 2878,  686, 2219,  450,
+    1887, 3104, 2644, 1103, 2999, 2113,  896,  352,
+    3794, 2097, 3582, 1159, 1635,   33, 1245, 3735,
+    1501, 3969, 2343, 1008, 2531,  670, 3848, 1237,
+    2728, 3917, 1627,  626, 3452,  206, 3321, 2773,
+    1304,  132, 1536,  490,  992, 3233, 2954, 1677 },
+  { 1152, 3146, 1411, 1861,  162, 3493,  578, 2725,
+     816, 2346, 3211,  348, 3996, 2375, 1851, 2898,
+    2145, 1661, 4073, 2606,  135, 1440, 3821, 1053,
+    3467, 1409,  740, 3742, 2383, 1421, 3322, 2551,
+    1301, 2887, 3268,  739, 2758, 3218, 2174, 2615,
+     551, 1795,  205, 2009, 3589, 2935,  935, 1929,
+     503, 3157, 2137, 1141, 2697, 1482,  571, 2057,
+    3156, 4022, 2134, 3709, 2625, 1354, 4070,  776 },
+  { 3713, 2715,  640, 4003, 2862, 2194, 1283, 1742,
+    3817, 1414, 2613, 1030, 3426, 1543,  812, 3843,
+     309, 2464,  500,  994, 3621, 3179, 1684, 2721,
+       8, 2296, 3271,  261, 1782,  458, 3891, 1915,
+     675,  294, 1774, 2482,  460, 3851,  799, 3380,
+    1113, 2820, 3168, 1395,  442, 1621, 3257, 2422,
+    1493, 3533,  164, 3024, 4004, 2403, 3729, 1703,
+     399, 1122, 2964, 1729,  676, 1942,  255, 2488 },
+  { 2010,   32, 3318,  974, 1554,  431, 3699, 3138,
+     247, 2988,  687, 1904, 2923,  478, 2713, 3225,
+    1102, 3712, 3005, 1808, 2327,  337, 2116,  788,
+    3924, 2906, 2029, 1266, 3473, 2817, 1049, 3106,
+    2316, 4044, 1448, 3687, 2017, 1357, 1752,  160,
+    2404, 3497,  809, 3940, 2698, 2128,   99, 4080,
+     817, 2601, 1021, 1869,  360,  805, 1187, 2668,
+    3571,  836, 2486,  165, 3427, 2841, 3593, 1510 },
+  { 3047, 1111, 2398, 1973, 3557, 2538,  885, 2321,
+    1154, 2041, 3900,   42, 3556, 2241, 1387,  152,
+    1977, 1458,  706, 3344, 1238, 2790, 3703, 1341,
+    1805,  483,  915, 4024, 2471,  757, 1584,   84,
+    3455, 1115, 2788,  126,  927, 3048, 2724, 4090,
+    1299, 1908,  249, 2286, 1060, 3383, 1288, 2821,
+     402, 2022, 3810, 1372, 3368, 2039, 2996,   25,
+    2292, 3373, 1478, 3889, 1184, 2233,  926,  541 },
+  { 3986, 1727, 3740,  524, 3004,  114, 1834, 4092,
+     476, 3333, 2415, 1247, 1716,  949, 4018, 2557,
+    3412, 2809, 2189,  102, 3972,  943,  432, 3408,
+    2547, 3608, 1642, 3066,  223, 1966, 3778, 2635,
+    1801,  795, 2112, 3384, 2380, 3595,  341, 2225,
+     649, 3660, 2993, 1687, 3711,  663, 1891, 3619,
+    1562, 3265, 2927,  633, 2341, 3667, 1541, 3970,
+    1850,  510, 2035, 3089,  426, 1685, 3263, 2602 },
+  { 1348,  354, 2832,  903, 1309, 3351, 2653, 1441,
+    2811, 1648,  850, 3694, 2670, 3076,  607, 1747,
+     909,  429, 3664, 1612, 2533, 1975, 3040, 2266,
+     121, 1137, 2683,  635, 2256, 3339, 1254, 2989,
+     508, 3816, 3119, 1267,  574, 1641, 1040, 3188,
+    1489, 2562,  971,  468, 2514, 3131,  260, 2277,
+    1083, 2438,   83, 1756, 2662,  283, 1041,  689,
+    3195, 1255, 2751,  818, 2401, 3722,  151, 2055 },
+  {  731, 3365, 2196, 1609, 3945, 2040,  601,  966,
+    3587,  163, 3145,  507, 2104,  254, 3492, 2409,
+    3882, 1307, 3090,  801, 3275, 1285,  650, 1544,
+    3251, 2051, 3812, 1375, 3565,  947,  371, 2201,
+    1491, 2478,  201, 1922, 3989, 2646, 2042, 3811,
+       7, 3409, 2049, 3910, 1523,  933, 2889, 3956,
+     577, 3471,  879, 4032, 1193, 3309, 2828, 1709,
+    2525, 3615,  318, 3957, 1452, 2883, 1078, 3575 },
+  { 1769, 2552,   81, 3124, 2390,  284, 3731, 3051,
+    2262, 1940, 2544, 1344, 3827, 1605, 1156, 2076,
+      17, 2718, 1894, 2330,  207, 3550, 2761, 3901,
+     975,  471, 2863,  157, 1665, 2597, 3222, 3999,
+    1011, 3461,  724, 2867, 1430,  382, 3006,  745,
+    1758, 2766, 1294,  232, 3320, 2149, 1751, 1332,
+    2627, 1920, 1423, 3086, 2072,  538, 2250, 3836,
+     192, 2107, 1058, 3244, 1933,  658, 2252, 3019 },
+  { 3921, 1182, 3508,  671, 1082, 2823, 1715, 1233,
+     419, 3951, 1010, 3404, 2733,  811, 2911, 3288,
+    1509, 3733,  523, 1127, 4030, 1768,  317, 1943,
+    2475, 3496, 1803, 2335, 3909,  683, 1902,   16,
+    1710, 2723, 2085, 3745,  919, 3358, 2324, 1217,
+    3586,  567, 2301, 3007,  754, 3796,   45, 3378,
+     373, 3698, 2771,  186, 3626, 1494, 3475,  870,
+    1391, 3057, 1623, 2619,   60, 3807, 1389,  265 },
+  {  844, 2132, 1480, 3791, 1947, 3433,  765, 2573,
+    3317, 1540,  665, 1870,  136, 2355, 4081,  590,
+     969, 2461, 3466, 2951, 1451, 2654,  875, 3067,
+    1337,  728, 3187, 1019, 2924, 1308, 3071, 2396,
+    3693, 1221,  282, 3155, 1824,  103, 3939, 1963,
+    2928, 1031, 4055, 1599, 2650, 1210, 2454, 3058,
+     960, 2187,  642, 2365, 1005, 1849,  380, 2905,
+    2356, 4060,  504, 3548, 1013, 2378, 3382, 2714 },
+  { 3272,  376, 2946, 2592,  174, 1328, 4040, 2127,
+       6, 2779, 2320, 3084, 3581, 1757,  361, 2020,
+    3141, 1704,  166, 2069,  669, 3369, 2280, 3700,
+      15, 4085, 1550,  417, 2066,  279, 3591,  899,
+     546, 3300, 1522, 2497, 1109, 2690, 1560,  475,
+    2474,  141, 3381, 1925,  422, 3625,  685, 1848,
+    1377, 3991, 1613, 3027, 3783, 2568, 3245, 1224,
+      95, 1827,  780, 2152, 2942, 1663,  592, 1917 },
+  { 2414, 3994, 1724,  608, 2258, 3068,  513, 1815,
+    3639, 1178, 3878,  480, 1055, 1415, 3361, 2839,
+    1274, 3950,  823, 2593, 3801,  357, 1169, 1668,
+    2093, 2750, 2374, 3374, 3732, 2657, 1530, 2155,
+    2884, 4053, 2243,  655, 3822, 3445,  819, 3139,
+    3708, 1413, 2211,  880, 3172, 1551, 2273, 3447,
+    2852,  118, 3297, 1177,  290,  749, 2060, 3654,
+    2487, 3428, 3123, 1262, 3933,  334, 3696, 1123 },
+  {   31, 1340,  881, 3662, 3357, 1594, 2674,  886,
+    3162,  310, 1690, 2091, 2641, 3727,  853, 2430,
+     281, 2173, 3390, 1071, 1830, 3159, 2492,  625,
+    3514,  335, 1214,  702, 1780, 1072, 3262,  130,
+    1874,  998,  316, 3018, 1969,  213, 2305, 1138,
+    1837, 2774,  347, 3852, 2846,  175, 3758,  462,
+    2574,  847, 2147, 1785, 2796, 4015, 1633,  479,
+     955, 1465, 2708,  222, 1996, 2499, 1486, 2983 },
+  { 2166, 3190, 2651, 1957, 1068,  351, 3883, 2235,
+    1463, 2836, 3454,  746, 3043,   74, 1881, 3867,
+     699, 2720, 1469, 2995,   75, 1364, 3965, 2798,
+    1003, 3220, 1961, 2953, 3982,  453, 2297, 3757,
+    1312, 2637, 1678, 3636, 1324, 2896, 1618, 4021,
+     634, 3335, 1066, 2520, 1335, 2071, 1017, 1764,
+    1227, 3842, 3572,  600, 2351, 1295, 3169, 2665,
+    3914, 2242,  585, 3516,  936, 2833,  638, 3446 },
+  { 1821,  531, 3847,  146, 2446, 2982, 1286, 3559,
+     615, 2402, 1116, 4035, 1449, 2275, 1211, 3210,
+    1680, 3503,  381, 2021, 3678, 2232,  444, 1914,
+    1444, 3877, 2507,  190, 1351, 2583,  849, 2966,
+     594, 3919, 3226,  778, 2470,  393, 3303, 2639,
+      51, 2109, 3612, 1728,  502, 3977, 3323, 2431,
+    3132, 1520,  256, 2957, 3463,   50,  876, 1951,
+     194, 1793, 3739, 1333, 3261, 1745, 4039,  988 },
+  { 3584, 1495, 2904, 1236, 3494,  714, 1884,   82,
+    3252, 1781,  226, 2529,  469, 3547, 2786,  221,
+    2228, 1165, 3920,  639, 2649,  851, 3337, 2974,
+     125,  775, 1622, 3569, 2052, 3385, 1718, 3541,
+    2004, 2333,   37, 1155, 1923, 3828,  938, 1986,
+    1366, 2975,  710, 3158, 2344,  824, 2909,    0,
+     664, 1946, 2617, 1096, 2056, 1581, 3746, 2873,
+    3346, 1100, 2955, 2441,   97, 2221,  407, 2628 },
+  {  184, 2309,  806, 2143, 1643, 4074, 2609, 2168,
+     977, 3800, 2976, 1991, 3160, 1603,  618, 3779,
+     865, 3115, 2472, 1743, 3450, 1242, 1644, 2424,
+    3691, 2169, 3078, 1024,  612, 2866,  142, 1183,
+     420, 1527, 2797, 3498, 3035, 1515,  554, 3537,
+    2433, 3903, 1591,  150, 3663, 1901, 1485, 3549,
+    2264, 4082, 3254,  735, 3861, 2566,  379, 1369,
+    2393,  323, 1662,  718, 3819, 1473, 3142, 1200 },
+  { 3021, 3963, 3432,  428, 3130,  298, 1393, 3648,
+    2755, 1484,  579, 1198, 3913,  939, 2603, 1948,
+    2902, 1563,  123, 1027, 2826,  277, 4093,  605,
+    1092, 2738,  296, 3845, 2387, 1497, 4086, 2691,
+    3150, 3734,  719, 2160,  234, 2672, 3185, 1205,
+     344,  874, 2775, 1256, 2604,  406, 1153, 2722,
+     908,  333, 1358, 1838,  489, 3207, 2190, 3502,
+     628, 4075, 2081, 3215, 2706,  889, 3658, 2006 },
+  { 1619, 1025, 2575, 1898, 2770, 1124, 3341,  777,
+     253, 1921, 3372, 2369,   36, 2198, 3334, 1329,
+     424, 4023, 3277, 2253, 3773, 1853, 3094, 2077,
+    1514, 3536, 1776, 1284, 3227,  459, 2151,  956,
+    2405, 1839, 1350, 3890, 1065, 1773, 4010, 2094,
+    2934, 1754, 3485, 2036, 4031, 3199, 2184, 3788,
+    1688, 2870, 3604, 2480, 2952, 1207,  891, 1806,
+    2678, 1009, 3460, 1259,  436, 1790, 2484,  624 },
+  { 2825,  329, 1417,  679, 3904, 2315, 1779, 2479,
+    3082, 3988,  898, 2705, 3637, 1744,  307, 3686,
+    2456,  810, 1982,  496, 1406,  767, 2505,   14,
+    3242,  533, 2240, 2907,  833, 3728, 1674, 3362,
+     613,  183, 3255, 2545,  505, 2363,  797,   71,
+    3759, 2357,  609,  245,  980, 1606,  705,  177,
+    3328, 1118, 2139,  191, 1537, 3995,   69, 3684,
+    3088, 1580,  154, 2354, 3011, 3975,   30, 3371 },
+  { 3763, 2114, 3580, 3228,  965,   24, 3785,  557,
+    1268, 2217, 1649,  457, 1399, 3060, 1044, 2849,
+    1809, 1252, 3578, 2596, 2919, 3488, 1213, 3873,
+    2664,  962, 3958,  252, 1954, 2661,   57, 1273,
+    3936, 2746,  857, 1976, 3668, 2895, 1272, 3204,
+    1507, 1063, 3264, 2882, 2511, 3561, 2941, 2416,
+    1941,  553, 3881,  854, 3431, 2338, 1952, 1325,
+     448, 2496, 3865, 1927,  950, 1429, 2234, 1188 },
+  { 1810, 2534,  228, 1638, 2869, 2099, 1466, 2743,
+    3500,  127, 2917, 3856,  798, 3486, 2148,  630,
+    3803,   58, 3081,  978,  209, 1695, 2265,  704,
+    1934, 1378, 3400, 2376, 1149, 3539, 3065, 1885,
+    2244, 3477, 1402, 3009,  314, 1620, 3478, 2626,
+     454, 2059, 3946, 1342, 1863,  433, 1219, 3927,
+    1426, 2805, 3171, 1732, 2712,  657, 3234, 2872,
+    2157,  800, 3308,  596, 3562, 2747, 3176,  813 },
+  {  512, 2997, 1093, 2389, 3741,  455, 3126,  796,
+    1980, 1089, 3287, 2468, 1832,  153, 2548, 1422,
+    3239, 2359, 1553, 2082, 3767, 3201,  332, 3552,
+    2990,  167, 1700, 3137,  520, 1535,  726, 2581,
+    1050,  405, 1755, 4038, 1128, 2254,  646, 1787,
+    3656, 2444,  784,   90, 3765, 2288,  803, 3441,
+      13,  958, 2308,  383, 1185, 3754,  272, 1022,
+    3792, 1467, 2682, 1708,  224, 2025,  365, 3866 },
+  { 3420, 1394, 4094,  652, 1841, 1148, 3631, 2509,
+    4033, 1548,  636, 2124, 1194, 2819, 4061,  386,
+    1958,  791, 3959,  537, 2465, 1142, 2696, 1549,
+    2181, 3809,  779, 2731, 4037, 2223, 3677,  278,
+    3844, 3189,  716, 2495,  169, 3091, 3820, 1015,
+     350, 3136, 1574, 2717, 3286, 1651, 3077, 1992,
+    2599, 1558, 3714, 3338, 2192, 1504, 2556, 1856,
+    3417,  116, 1129, 3198, 4036, 1271, 2515, 1617 },
+  { 2126, 2699,  108, 3079, 3453, 2342,  155, 1712,
+     375, 2880, 3753,  248, 3570, 1559, 3170, 1076,
+    3545, 2730, 1231, 2998, 1864,  755, 4049,  495,
+    1007, 2567, 1280, 1993,   94, 1081, 1788, 2868,
+    1472, 2111, 2794, 1882, 3583, 1428, 2694, 1936,
+    2916, 1208, 3474, 2027, 1033,  302, 2493,  565,
+    4045, 3044,  259, 1939,  794, 2986, 4071,  526,
+    2318, 2933, 1964, 2372,  839, 2959, 3600,  945 },
+  { 3253,  733, 1981, 1589,  893, 2838, 1303, 3363,
+    2261,  995, 2578, 3070,  925, 1983,  672, 2385,
+    1705,  193, 3424,  395, 3702, 1404, 3302, 1823,
+    3110, 3672,  414, 3464, 2920, 3281, 2371,  845,
+    3416,   29, 1181, 3311,  834,  501, 2172,   64,
+    4065, 2323,  230,  682, 3961, 1416, 3568, 1180,
+    1798,  848, 1327, 2685, 3647,   61, 1121, 1686,
+     773, 3868,  421, 3491, 1571,  587, 2257,  267 },
+  { 1315, 3641, 2467, 3923,  362, 2125, 3835,  737,
+    3028, 1425, 1811,  494, 2287, 3884,   72, 2973,
+    3813, 2206, 1570, 2527, 2023,   12, 2312, 2812,
+     198, 1461, 2400, 1725,  666, 1420,  451, 3640,
+    2516,  619, 3967, 1592, 2397, 3864, 3223, 1317,
+     756, 1753, 3666, 2553, 2943, 2159, 3193,  109,
+    2847, 2322, 3850,  486, 1749, 2350, 3522, 2675,
+    3175, 1450, 1051, 2780,   41, 3755, 1847, 2865 },
+  { 1679,  472, 1114, 2777, 1408, 3186,  511, 1880,
+    3606,   44, 3971, 3205, 1133, 3407, 2586, 1305,
+     920,  570, 3246,  961, 2913, 3476, 1170,  843,
+    3841, 2062,  900, 3607, 2546, 3944, 2043, 1218,
+    1720, 3031, 2239,  315, 2901, 1048, 1707, 3543,
+    2784, 3166, 1045, 1557,  412,  869, 1865, 3808,
+     637, 3217, 2030, 3386,  990, 3101, 1338, 2073,
+     161, 3601, 2193, 1740, 3134, 2432, 1038, 4008 },
+  { 2588, 2154, 3269,   65, 3528, 1701, 2528, 1189,
+    2735, 2199,  656, 2521, 1669,  312, 1526, 3670,
+    1960, 2677, 4026, 1363,  659, 3915, 1597, 2630,
+     519, 3284, 2860,  237, 1067, 3054,  112, 2719,
+    3749,  928, 1362, 3574, 1972,  172, 2579,  525,
+    2260,  326, 2089, 3306, 3870, 2361, 1287, 2612,
+    1653, 1110,  170, 1524, 2824,  653,  368, 3983,
+     940, 2503,  631, 3949, 1258,  721, 3377,  171 },
+  {  911, 3680, 1844,  764, 2329,  970, 4057,  225,
+    3290,  916, 1390, 3627, 2045, 2910,  711, 3283,
+     359, 3049,  129, 1819, 2417,  308, 2163, 3197,
+    1765, 1253, 4062, 1555, 2248, 1804, 3359,  392,
+    2175,  440, 3248, 2642,  742, 3108, 3766, 1531,
+     888, 3980, 1297,   28, 2853,  576, 3624,  270,
+    3470, 2763, 3935, 2366, 3704, 1820, 3276, 1545,
+    2877, 1858, 3336,  212, 2663, 2068, 1483, 3032 }
+};
+
+// For Emacs:
+// Local Variables:
+// mode:c++
+// indent-tabs-mode:nil
+// tab-width:2
+// c-basic-offset:2
+// c-file-style: nil
+// End:
+// For VIM:
+// vim:set expandtab softtabstop=2 shiftwidth=2 tabstop=2:
@@ -0,0 +1,149 @@
+// hiptext - Image to Text Converter
+// By Justine Tunney
+
+#include "hiptext/convolve.h"
+
+#include <algorithm>
+#include <cmath>
+
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
+
+#include "hiptext/graphic.h"
+#include "hiptext/parallel.h"
+#include "hiptext/pixel.h"
+
+namespace {
+
+// out[x] = sum of kernel[k] * in[k][x], where each 'in' is a row of 'width'
+// floats. The horizontal pass hands in the same padded row shifted by one
+// each time, and the vertical one the rows above and below.
+void Accumulate(const float* const* in, const float* kernel, int size,
+                float* out, int width) {
+  int x = 0;
+#ifdef __SSE__
+  for (; x + 4 <= width; x += 4) {
+    __m128 sum = _mm_setzero_ps();
+    for (int k = 0; k < size; ++k) {
+      sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(kernel[k]),
+                                       _mm_loadu_ps(in[k] + x)));
+    }
+    _mm_storeu_ps(out + x, sum);
+  }
+#endif
+  for (; x < width; ++x) {
+    float sum = 0.0f;
+    for (int k = 0; k < size; ++k) {
+      sum += kernel[k] * in[k][x];
+    }
+    out[x] = sum;
+  }
+}
+
+}  // namespace
+
+Plane GreyPlane(const Graphic& graphic) {
+  Plane res(graphic.width(), graphic.height());
+  for (int y = 0; y < graphic.height(); ++y) {
+    float* row = res.row(y);
+    for (int x = 0; x < graphic.width(); ++x) {
+      row[x] = graphic.Get(x, y).grey();
+    }
+  }
+  return res;
+}
+
+Plane ConvolveSeparable(const Plane& src, const std::vector<float>& horizontal,
+                        const std::vector<float>& vertical) {
+  CHECK(horizontal.size() % 2 == 1 && vertical.size() % 2 == 1);
+  const int width = src.width();
+  const int height = src.height();
+  const int hsize = horizontal.size();
+  const int hradius = hsize / 2;
+  const int vsize = vertical.size();
+  const int vradius = vsize / 2;
+  Plane tmp(width, height);
+  Plane res(width, height);
+  if (!width || !height) {
+    return res;
+  }
+
+  ParallelFor(0, height, [&](int y) {
+    // Copy the row with its edges repeated, so the kernel never runs off it.
+    static thread_local std::vector<float> padded;
+    padded.resize(width + hsize - 1);
+    const float* row = src.row(y);
+    std::fill(padded.begin(), padded.begin() + hradius, row[0]);
+    std::copy(row, row + width, padded.begin() + hradius);
+    std::fill(padded.begin() + hradius + width, padded.end(), row[width - 1]);
+    static thread_local std::vector<const float*> in;
+    in.resize(hsize);
+    for (int k = 0; k < hsize; ++k) {
+      in[k] = &padded[k];
+    }
+    Accumulate(in.data(), horizontal.data(), hsize, tmp.row(y), width);
+  });
+
+  ParallelFor(0, height, [&](int y) {
+    static thread_local std::vector<const float*> in;
+    in.resize(vsize);
+    for (int k = 0; k < vsize; ++k) {
+      in[k] = tmp.row(std::max(0, std::min(height - 1, y + k - vradius)));
+    }
+    Accumulate(in.data(), vertical.data(), vsize, res.row(y), width);
+  });
+  return res;
+}
+
+std::vector<float> GaussianKernel(double sigma) {
+  CHECK_GT(sigma, 0.0);
+  int radius = std::max(1, static_cast<int>(std::ceil(sigma * 3.0)));
+  std::vector<float> res(radius * 2 + 1);
+  double total = 0.0;
+  for (int n = -radius; n <= radius; ++n) {
+    double weight = std::exp(-n * n / (2.0 * sigma * sigma));
+    res[n + radius] = weight;
+    total += weight;
+  }
+  for (float& weight : res) {
+    weight /= total;
+  }
+  return res;
+}
+
+Plane GaussianBlur(const Plane& src, double sigma) {
+  std::vector<float> kernel = GaussianKernel(sigma);
+  return ConvolveSeparable(src, kernel, kernel);
+}
+
+Plane Sharpen(const Plane& src, double sigma, double amount) {
+  Plane res = GaussianBlur(src, sigma);
+  const float a = amount;
+  for (int y = 0; y < src.height(); ++y) {
+    const float* in = src.row(y);
+    float* out = res.row(y);
+    for (int x = 0; x < src.width(); ++x) {
+      out[x] = in[x] + a * (in[x] - out[x]);
+    }
+  }
+  return res;
+}
+
+void Sobel(const Plane& src, Plane* gx, Plane* gy) {
+  static const std::vector<float> kDerive = {-1.0f, 0.0f, 1.0f};
+  static const std::vector<float> kSmooth = {1.0f, 2.0f, 1.0f};
+  *gx = ConvolveSeparable(src, kDerive, kSmooth);
+  *gy = ConvolveSeparable(src, kSmooth, kDerive);
+}
+
+// For Emacs:
+// Local Variables:
+// mode:c++
+// indent-tabs-mode:nil
+// tab-width:2
+// c-basic-offset:2
+// c-file-style: nil
+// End:
+// For VIM:
+// vim:set expandtab softtabstop=2 shiftwidth=2 tabstop=2:
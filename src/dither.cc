@@ -0,0 +1,303 @@
+// hiptext - Image to Text Converter
+// By Justine Tunney
+
+#include "hiptext/dither.h"
+
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include "hiptext/artiste.h"
+#include "hiptext/bluenoise.h"
+#include "hiptext/graphic.h"
+#include "hiptext/parallel.h"
+#include "hiptext/pixel.h"
+
+DEFINE_string(dither, "none", "Dithering for palette based modes: none, "
+              "floyd (Floyd-Steinberg), sierra (Sierra Lite), bayer or "
+              "bluenoise. The last two are ordered, which is faster and "
+              "doesn't smear errors across the image");
+DEFINE_string(video_dither, "bluenoise", "Dithering for movies and animations "
+              "when --dither is error diffusion. Ordered modes keep still "
+              "parts of the picture identical from frame to frame, which "
+              "avoids shimmer");
+
+namespace {
+
+// A square tile of thresholds in [-0.5, 0.5), with a power of two size.
+struct ThresholdMap {
+  int size;
+  std::vector<float> value;
+};
+
+ThresholdMap MakeBayer() {
+  ThresholdMap map = {1, {0.0f}};
+  std::vector<int> rank = {0};
+  while (map.size < 8) {
+    int n = map.size;
+    std::vector<int> next(4 * n * n);
+    for (int y = 0; y < n; ++y) {
+      for (int x = 0; x < n; ++x) {
+        int r = 4 * rank[y * n + x];
+        next[y * 2 * n + x] = r;
+        next[y * 2 * n + x + n] = r + 2;
+        next[(y + n) * 2 * n + x] = r + 3;
+        next[(y + n) * 2 * n + x + n] = r + 1;
+      }
+    }
+    rank = std::move(next);
+    map.size *= 2;
+  }
+  map.value.resize(rank.size());
+  for (size_t n = 0; n < rank.size(); ++n) {
+    map.value[n] = (rank[n] + 0.5f) / rank.size() - 0.5f;
+  }
+  return map;
+}
+
+ThresholdMap MakeBlueNoise() {
+  const int size = 64;
+  const int area = size * size;
+  ThresholdMap map = {size, std::vector<float>(area)};
+  for (int y = 0; y < size; ++y) {
+    for (int x = 0; x < size; ++x) {
+      map.value[y * size + x] = (g_blue_noise[y][x] + 0.5f) / area - 0.5f;
+    }
+  }
+  return map;
+}
+
+const ThresholdMap& GetThresholdMap(DitherMode mode) {
+  static const ThresholdMap bayer = MakeBayer();
+  if (mode == DitherMode::kBayer) {
+    return bayer;
+  }
+  static const ThresholdMap blue_noise = MakeBlueNoise();
+  return blue_noise;
+}
+
+inline int Clamp(int value) {
+  return std::max(0, std::min(255, value));
+}
+
+// Ordered dithering should nudge colors about as far as the typical gap
+// between neighboring palette entries, which we measure as the mean distance
+// from each color to its nearest neighbor. That's quadratic in the palette
+// size, and SIXEL video makes a Ditherer for every frame, nearly always with
+// the same palette as the last one, so the last answer is remembered.
+int PaletteSpread(const uint8_t (*palette)[3], int begin, int end) {
+  static std::mutex mutex;
+  static std::vector<uint8_t> last_colors;
+  static int last_spread = 0;
+  const uint8_t* first = palette[begin];
+  std::vector<uint8_t> colors(first, first + (end - begin) * 3);
+  std::lock_guard<std::mutex> lock(mutex);
+  if (colors == last_colors) {
+    return last_spread;
+  }
+  double total = 0.0;
+  for (int i = begin; i < end; ++i) {
+    int nearest = 3 * 255 * 255 + 1;
+    for (int j = begin; j < end; ++j) {
+      int dr = palette[i][0] - palette[j][0];
+      int dg = palette[i][1] - palette[j][1];
+      int db = palette[i][2] - palette[j][2];
+      int dist = dr * dr + dg * dg + db * db;
+      if (j != i && dist > 0) {
+        nearest = std::min(nearest, dist);
+      }
+    }
+    total += std::sqrt(nearest);
+  }
+  last_colors = std::move(colors);
+  last_spread = static_cast<int>(total / (end - begin) + 0.5);
+  return last_spread;
+}
+
+// How many pixels wide the scaled threshold rows are. A multiple of every
+// map's size, so a tile always starts where a row of offsets does.
+const int kOffsetWidth = 64;
+
+// Loads row 'y' as packed 8-bit RGB.
+void LoadRow(const Graphic& graphic, int y, uint8_t* rgb) {
+  for (int x = 0; x < graphic.width(); ++x, rgb += 3) {
+    const Pixel& pix = graphic.Get(x, y);
+    rgb[0] = ToByte(pix.red());
+    rgb[1] = ToByte(pix.green());
+    rgb[2] = ToByte(pix.blue());
+  }
+}
+
+// rgb[i] = Clamp(rgb[i] + offset[i]) for 'count' channels.
+void AddClamped(uint8_t* rgb, const int16_t* offset, int count) {
+  int i = 0;
+#ifdef __SSE2__
+  // Widen to 16 bits for the add, then let the pack saturate back to bytes.
+  const __m128i zero = _mm_setzero_si128();
+  for (; i + 16 <= count; i += 16) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rgb + i));
+    __m128i lo = _mm_add_epi16(
+        _mm_unpacklo_epi8(v, zero),
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(offset + i)));
+    __m128i hi = _mm_add_epi16(
+        _mm_unpackhi_epi8(v, zero),
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(offset + i + 8)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(rgb + i),
+                     _mm_packus_epi16(lo, hi));
+  }
+#endif
+  for (; i < count; ++i) {
+    rgb[i] = Clamp(rgb[i] + offset[i]);
+  }
+}
+
+}  // namespace
+
+DitherMode ParseDitherMode(const std::string& name) {
+  if (name == "none") {
+    return DitherMode::kNone;
+  } else if (name == "floyd") {
+    return DitherMode::kFloydSteinberg;
+  } else if (name == "sierra") {
+    return DitherMode::kSierraLite;
+  } else if (name == "bayer") {
+    return DitherMode::kBayer;
+  } else if (name == "bluenoise") {
+    return DitherMode::kBlueNoise;
+  }
+  LOG(FATAL) << "Unknown dither mode: " << name;
+  return DitherMode::kNone;
+}
+
+DitherMode GetDitherMode() {
+  DitherMode mode = ParseDitherMode(FLAGS_dither);
+  if (IsPlayingVideo() && (mode == DitherMode::kFloydSteinberg ||
+                           mode == DitherMode::kSierraLite)) {
+    return ParseDitherMode(FLAGS_video_dither);
+  }
+  return mode;
+}
+
+Ditherer::Ditherer(DitherMode mode, Quantizer quantize,
+                   const Pixel* palette, int begin, int end)
+    : mode_(mode), quantize_(quantize) {
+  CHECK(0 <= begin && begin < end && end <= 256);
+  for (int n = 0; n < 256; ++n) {
+    const Pixel& pix = palette[std::max(begin, std::min(end - 1, n))];
+    palette_[n][0] = ToByte(pix.red());
+    palette_[n][1] = ToByte(pix.green());
+    palette_[n][2] = ToByte(pix.blue());
+  }
+  if (mode_ == DitherMode::kBayer || mode_ == DitherMode::kBlueNoise) {
+    // Thresholds are tiled by screen position, so the same pixel in the same
+    // spot always lands on the same palette entry.
+    const ThresholdMap& map = GetThresholdMap(mode_);
+    int spread = PaletteSpread(palette_, begin, end);
+    int mask = map.size - 1;
+    offset_rows_ = map.size;
+    offsets_.resize(map.size * kOffsetWidth * 3);
+    int16_t* offset = offsets_.data();
+    for (int y = 0; y < map.size; ++y) {
+      for (int x = 0; x < kOffsetWidth; ++x, offset += 3) {
+        offset[0] = offset[1] = offset[2] =
+            static_cast<int>(map.value[y * map.size + (x & mask)] * spread);
+      }
+    }
+  }
+}
+
+void Ditherer::QuantizeRow(const Graphic& graphic, int y, uint8_t* out) {
+  if (mode_ == DitherMode::kFloydSteinberg ||
+      mode_ == DitherMode::kSierraLite) {
+    Diffuse(graphic, y, out);
+  } else {
+    Order(graphic, y, out);
+  }
+}
+
+std::vector<uint8_t> Ditherer::Quantize(const Graphic& graphic) {
+  int width = graphic.width();
+  std::vector<uint8_t> out(width * graphic.height());
+  if (mode_ == DitherMode::kFloydSteinberg ||
+      mode_ == DitherMode::kSierraLite) {
+    for (int y = 0; y < graphic.height(); ++y) {
+      Diffuse(graphic, y, out.data() + y * width);
+    }
+  } else {
+    ParallelFor(0, graphic.height(), [&](int y) {
+      Order(graphic, y, out.data() + y * width);
+    });
+  }
+  return out;
+}
+
+void Ditherer::Diffuse(const Graphic& graphic, int y, uint8_t* out) {
+  int width = graphic.width();
+  // Errors are in sixteenths of a level. Both rows have a column of padding
+  // on either side so the edges need no special cases.
+  if (y == 0) {
+    cur_.assign(3 * (width + 2), 0);
+  }
+  next_.assign(3 * (width + 2), 0);
+  std::vector<uint8_t> rgb(3 * width);
+  LoadRow(graphic, y, rgb.data());
+  bool floyd = mode_ == DitherMode::kFloydSteinberg;
+  for (int x = 0; x < width; ++x) {
+    int* here = &cur_[3 * (x + 1)];
+    int* below = &next_[3 * (x + 1)];
+    uint8_t v[3];
+    for (int k = 0; k < 3; ++k) {
+      v[k] = Clamp(rgb[3 * x + k] + here[k] / 16);
+    }
+    uint8_t code;
+    quantize_(v, 1, &code);
+    *out++ = code;
+    for (int k = 0; k < 3; ++k) {
+      int e = v[k] - palette_[code][k];
+      if (floyd) {
+        here[3 + k] += 7 * e;
+        below[-3 + k] += 3 * e;
+        below[k] += 5 * e;
+        below[3 + k] += e;
+      } else {
+        here[3 + k] += 8 * e;
+        below[-3 + k] += 4 * e;
+        below[k] += 4 * e;
+      }
+    }
+  }
+  std::swap(cur_, next_);
+}
+
+void Ditherer::Order(const Graphic& graphic, int y, uint8_t* out) const {
+  int width = graphic.width();
+  std::vector<uint8_t> rgb(3 * width);
+  LoadRow(graphic, y, rgb.data());
+  if (offset_rows_) {
+    const int16_t* row = &offsets_[(y % offset_rows_) * kOffsetWidth * 3];
+    for (int x = 0; x < width; x += kOffsetWidth) {
+      AddClamped(&rgb[3 * x], row, 3 * std::min(kOffsetWidth, width - x));
+    }
+  }
+  quantize_(rgb.data(), width, out);
+}
+
+// For Emacs:
+// Local Variables:
+// mode:c++
+// indent-tabs-mode:nil
+// tab-width:2
+// c-basic-offset:2
+// c-file-style: nil
+// End:
+// For VIM:
+// vim:set expandtab softtabstop=2 shiftwidth=2 tabstop=2:
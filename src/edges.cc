@@ -0,0 +1,105 @@
+// hiptext - Image to Text Converter
+// By Justine Tunney
+
+#include "hiptext/edges.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include "hiptext/artiste.h"
+#include "hiptext/charquantizer.h"
+#include "hiptext/convolve.h"
+#include "hiptext/graphic.h"
+#include "hiptext/parallel.h"
+#include "hiptext/pixel.h"
+#include "hiptext/unicode.h"
+
+DEFINE_string(edge_chars, "-\\|/", "Lines to draw edges with in --edges "
+              "mode: horizontal, falling, vertical and rising");
+DEFINE_double(edge_threshold, 0.15, "How strong an edge has to be for --edges "
+              "to draw it, where 1 is a black to white step filling the cell");
+DECLARE_string(chars);
+
+// Below this, gradients in a cell point every which way, which is texture or
+// noise rather than an edge.
+static const double kMinCoherence = 0.5;
+
+// Sobel responds to a step from zero to one with four.
+static const double kSobelGain = 4.0;
+
+int EdgeOrientation(double sxx, double syy, double sxy) {
+  // The gradient's main direction, from the structure tensor, is across the
+  // edge, so the edge itself is a quarter turn round from it.
+  double across = 0.5 * std::atan2(2.0 * sxy, sxx - syy);
+  double along = across + M_PI / 2.0;
+  int bin = static_cast<int>(std::floor(along / (M_PI / 4.0) + 0.5));
+  return ((bin % 4) + 4) % 4;
+}
+
+void PrintImageEdges(std::ostream& os, const Graphic& graphic) {
+  const std::wstring edge_chars = DecodeText(FLAGS_edge_chars);
+  CHECK_EQ(4, edge_chars.size()) << "--edge_chars needs four characters.";
+  const CharQuantizer quantizer(DecodeText(FLAGS_chars), 256);
+  const bool invert = HasLightBackground();
+  const int cols = graphic.width() / kEdgeCellWidth;
+  const int rows = graphic.height() / kEdgeCellHeight;
+  const int area = kEdgeCellWidth * kEdgeCellHeight;
+
+  // A little blur first keeps noise and dithering from passing for edges.
+  const Plane grey = GreyPlane(graphic);
+  Plane gx(0, 0);
+  Plane gy(0, 0);
+  Sobel(GaussianBlur(grey, 1.0), &gx, &gy);
+
+  std::vector<wchar_t> glyphs(cols * rows);
+  ParallelFor(0, rows, [&](int row) {
+    for (int col = 0; col < cols; ++col) {
+      double sxx = 0.0;
+      double syy = 0.0;
+      double sxy = 0.0;
+      double level = 0.0;
+      for (int y = row * kEdgeCellHeight; y < (row + 1) * kEdgeCellHeight;
+           ++y) {
+        for (int x = col * kEdgeCellWidth; x < (col + 1) * kEdgeCellWidth;
+             ++x) {
+          double dx = gx.Get(x, y) / kSobelGain;
+          double dy = gy.Get(x, y) / kSobelGain;
+          sxx += dx * dx;
+          syy += dy * dy;
+          sxy += dx * dy;
+          level += grey.Get(x, y);
+        }
+      }
+      double strength = std::sqrt((sxx + syy) / area);
+      double spread = std::sqrt((sxx - syy) * (sxx - syy) + 4.0 * sxy * sxy);
+      wchar_t& glyph = glyphs[row * cols + col];
+      if (strength >= FLAGS_edge_threshold &&
+          spread >= kMinCoherence * (sxx + syy)) {
+        glyph = edge_chars[EdgeOrientation(sxx, syy, sxy)];
+      } else {
+        int shade = ToByte(level / area);
+        glyph = quantizer.Quantize(invert ? 255 - shade : shade);
+      }
+    }
+  });
+
+  for (int row = 0; row < rows; ++row) {
+    os << std::wstring(glyphs.data() + row * cols, cols) << "\n";
+  }
+}
+
+// For Emacs:
+// Local Variables:
+// mode:c++
+// indent-tabs-mode:nil
+// tab-width:2
+// c-basic-offset:2
+// c-file-style: nil
+// End:
+// For VIM:
+// vim:set expandtab softtabstop=2 shiftwidth=2 tabstop=2:
@@ -3,6 +3,8 @@
 
 #include "hiptext/font.h"
 
+#include <utility>
+
 #include <ft2build.h>
 #include FT_FREETYPE_H
 #include <gflags/gflags.h>
@@ -20,25 +22,44 @@ DEFINE_bool(hinting, false, "Enable font hinting.");
 
 static FT_Library g_library;
 static FT_Face g_face;
+static int g_size;  // Current size of g_face in points.
 
 static int GetFontLoadFlags() {
   return (FT_LOAD_RENDER | FT_LOAD_LINEAR_DESIGN |
           ((FLAGS_hinting) ? 0 : FT_LOAD_NO_HINTING));
 }
 
+static int CalculateBaseline(double advance, double descender, double height) {
+  return advance * descender / height + advance;
+}
+
+// Switches the face to 'size' points, if it isn't already.
+static void SetFontSize(int size) {
+  if (size != g_size) {
+    CHECK_EQ(0, FT_Set_Char_Size(g_face, size << 6, 0, FLAGS_font_dpi, 0));
+    g_size = size;
+  }
+}
+
 void InitFont() {
   CHECK_EQ(0, FT_Init_FreeType(&g_library));
   CHECK_EQ(0, FT_New_Face(
       g_library, FLAGS_font.c_str(), FLAGS_font_index, &g_face));
-  CHECK_EQ(0, FT_Set_Char_Size(
-      g_face, FLAGS_font_size << 6, 0, FLAGS_font_dpi, 0));
-}
-
-static int CalculateBaseline(double advance, double descender, double height) {
-  return advance * descender / height + advance;
+  g_size = 0;
+  SetFontSize(FLAGS_font_size);
 }
 
-Graphic LoadLetter(wchar_t letter, const Pixel& fg, const Pixel& bg) {
+const Glyph& GlyphAtlas::Get(wchar_t letter, int size) {
+  if (size == 0) {
+    size = FLAGS_font_size;
+  }
+  uint64_t key = (static_cast<uint64_t>(size) << 32 |
+                  static_cast<uint32_t>(letter));
+  auto it = glyphs_.find(key);
+  if (it != glyphs_.end()) {
+    return it->second;
+  }
+  SetFontSize(size);
   CHECK_EQ(0, FT_Load_Char(g_face, letter, GetFontLoadFlags()));
   FT_Bitmap* bitmap = &g_face->glyph->bitmap;
   FT_Glyph_Metrics* metrics = &g_face->glyph->metrics;
@@ -49,23 +70,43 @@ Graphic LoadLetter(wchar_t letter, const Pixel& fg, const Pixel& bg) {
   const int height = metrics->vertAdvance >> 6;
   const int offset_x = metrics->horiBearingX >> 6;
   const int offset_y = (baseline - metrics->horiBearingY) >> 6;
-  Graphic graphic(width, height, bg);
+  Glyph glyph = {width, height, baseline >> 6, pixels_.size()};
+  pixels_.resize(pixels_.size() + width * height);
+  uint8_t* cell = &pixels_[glyph.offset];
   for (unsigned y = 0; y < bitmap->rows; ++y) {
     int y2 = y + offset_y;
     if (y2 < 0 || y2 >= height)
       continue;
     for (unsigned x = 0; x < bitmap->width; ++x) {
-      uint8_t grey = bitmap->buffer[y * bitmap->width + x];
-      if (grey) {
-        int x2 = x + offset_x;
-        if (x2 < 0 || x2 >= width)
-          continue;
-        double grey255 = grey / 255;
-        graphic.Get(x2, y2).Overlay(fg.Copy().set_alpha(grey255));
-      }
+      int x2 = x + offset_x;
+      if (x2 < 0 || x2 >= width)
+        continue;
+      cell[y2 * width + x2] = bitmap->buffer[y * bitmap->pitch + x];
     }
   }
-  return graphic;
+  return glyphs_.emplace(key, glyph).first->second;
+}
+
+GlyphAtlas& GetGlyphAtlas() {
+  static GlyphAtlas* atlas = new GlyphAtlas;
+  return *atlas;
+}
+
+Graphic LoadLetter(wchar_t letter, const Pixel& fg, const Pixel& bg) {
+  GlyphAtlas& atlas = GetGlyphAtlas();
+  const Glyph& glyph = atlas.Get(letter);
+  // Blend each coverage level once rather than once per pixel.
+  Pixel shades[256];
+  shades[0] = bg;
+  for (int level = 1; level < 256; ++level) {
+    shades[level] = bg.Copy().Overlay(fg.Copy().set_alpha(level / 255.0));
+  }
+  const uint8_t* coverage = atlas.coverage(glyph);
+  std::vector<Pixel> pixels(glyph.width * glyph.height);
+  for (size_t n = 0; n < pixels.size(); ++n) {
+    pixels[n] = shades[coverage[n]];
+  }
+  return Graphic(glyph.width, glyph.height, std::move(pixels));
 }
 
 // For Emacs:
@@ -0,0 +1,60 @@
+// hiptext - Image to Text Converter
+// By Justine Tunney
+
+#include "hiptext/framecache.h"
+
+#include <algorithm>
+#include <utility>
+
+#include <glog/logging.h>
+
+#include "hiptext/graphic.h"
+#include "hiptext/pixel.h"
+
+void FrameCache::Add(const Graphic& graphic, double delay) {
+  if (frames_.empty()) {
+    width_ = graphic.width();
+    height_ = graphic.height();
+  }
+  CHECK(graphic.width() == width_ && graphic.height() == height_)
+      << "Animation frames must all be the same size.";
+  std::vector<uint8_t> rgb(width_ * height_ * 3);
+  uint8_t* p = rgb.data();
+  for (int y = 0; y < height_; ++y) {
+    for (int x = 0; x < width_; ++x) {
+      const Pixel& pixel = graphic.Get(x, y);
+      *p++ = ToByte(pixel.red());
+      *p++ = ToByte(pixel.green());
+      *p++ = ToByte(pixel.blue());
+    }
+  }
+  if (!frames_.empty() && frames_.back().rgb == rgb) {
+    frames_.back().delay += delay;
+    return;
+  }
+  bytes_ += rgb.size();
+  frames_.push_back(Frame{std::move(rgb), delay});
+}
+
+Graphic FrameCache::Get(int index) const {
+  DCHECK_GE(index, 0);
+  DCHECK_LT(index, size());
+  const uint8_t* p = frames_[index].rgb.data();
+  std::vector<Pixel> pixels;
+  pixels.reserve(width_ * height_);
+  for (int n = 0; n < width_ * height_; ++n, p += 3) {
+    pixels.emplace_back(p[0], p[1], p[2]);
+  }
+  return Graphic(width_, height_, std::move(pixels));
+}
+
+// For Emacs:
+// Local Variables:
+// mode:c++
+// indent-tabs-mode:nil
+// tab-width:2
+// c-basic-offset:2
+// c-file-style: nil
+// End:
+// For VIM:
+// vim:set expandtab softtabstop=2 shiftwidth=2 tabstop=2:
@@ -0,0 +1,147 @@
+// hiptext - Image to Text Converter
+// By Justine Tunney
+
+#include "hiptext/glyphmatcher.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <utility>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include "hiptext/artiste.h"
+#include "hiptext/font.h"
+#include "hiptext/graphic.h"
+#include "hiptext/parallel.h"
+#include "hiptext/pixel.h"
+#include "hiptext/unicode.h"
+
+DEFINE_string(glyph_set, " !\"#$%&'()*+,-./0123456789:;<=>?@"
+              "ABCDEFGHIJKLMNOPQRSTUVWXYZ[\\]^_`"
+              "abcdefghijklmnopqrstuvwxyz{|}~",
+              "Characters to choose from with --glyphs. Put the blank one "
+              "first, since ties go to earlier characters");
+
+static_assert(GlyphMatcher::kSize % 16 == 0, "SAD works 16 bytes at a time");
+
+static inline int Distance(const uint8_t* a, const uint8_t* b) {
+#ifdef __SSE2__
+  __m128i sum = _mm_setzero_si128();
+  for (int n = 0; n < GlyphMatcher::kSize; n += 16) {
+    __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + n));
+    __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + n));
+    sum = _mm_add_epi64(sum, _mm_sad_epu8(x, y));
+  }
+  return _mm_cvtsi128_si32(sum) +
+         _mm_cvtsi128_si32(_mm_unpackhi_epi64(sum, sum));
+#else
+  int sum = 0;
+  for (int n = 0; n < GlyphMatcher::kSize; ++n) {
+    sum += std::abs(a[n] - b[n]);
+  }
+  return sum;
+#endif
+}
+
+GlyphMatcher::GlyphMatcher(const std::wstring& glyphs) : glyphs_(glyphs) {
+  CHECK(!glyphs_.empty());
+  // Average the ink over each part of the glyph's cell.
+  GlyphAtlas& atlas = GetGlyphAtlas();
+  std::vector<double> ink(glyphs_.size() * kSize);
+  double most = 0.0;
+  for (size_t n = 0; n < glyphs_.size(); ++n) {
+    const Glyph& glyph = atlas.Get(glyphs_[n]);
+    const uint8_t* coverage = atlas.coverage(glyph);
+    int width = glyph.width;
+    int height = glyph.height;
+    CHECK(width >= kWidth && height >= kHeight) << "Font is too small.";
+    for (int fy = 0; fy < kHeight; ++fy) {
+      for (int fx = 0; fx < kWidth; ++fx) {
+        int x0 = fx * width / kWidth;
+        int x1 = (fx + 1) * width / kWidth;
+        int y0 = fy * height / kHeight;
+        int y1 = (fy + 1) * height / kHeight;
+        int total = 0;
+        for (int y = y0; y < y1; ++y) {
+          for (int x = x0; x < x1; ++x) {
+            total += coverage[y * width + x];
+          }
+        }
+        double level = total / 255.0 / ((x1 - x0) * (y1 - y0));
+        ink[n * kSize + fy * kWidth + fx] = level;
+        most = std::max(most, level);
+      }
+    }
+  }
+  // No glyph fills its cell, so stretch the levels to cover the image's.
+  features_.resize(ink.size());
+  for (size_t n = 0; n < ink.size(); ++n) {
+    features_[n] = ToByte(most > 0.0 ? ink[n] / most : 0.0);
+  }
+}
+
+GlyphMatcher::GlyphMatcher(const std::wstring& glyphs,
+                           std::vector<uint8_t> features)
+    : glyphs_(glyphs), features_(std::move(features)) {
+  CHECK(!glyphs_.empty());
+  CHECK_EQ(glyphs_.size() * kSize, features_.size());
+}
+
+int GlyphMatcher::Match(const uint8_t* block) const {
+  int best = 0;
+  int best_distance = Distance(block, &features_[0]);
+  for (size_t n = 1; n < glyphs_.size(); ++n) {
+    int distance = Distance(block, &features_[n * kSize]);
+    if (distance < best_distance) {
+      best = n;
+      best_distance = distance;
+    }
+  }
+  return best;
+}
+
+void PrintImageGlyphs(std::ostream& os, const Graphic& graphic) {
+  static const GlyphMatcher matcher(DecodeText(FLAGS_glyph_set));
+  const int kWidth = GlyphMatcher::kWidth;
+  const int kHeight = GlyphMatcher::kHeight;
+  bool invert = HasLightBackground();
+  int cols = graphic.width() / kWidth;
+  int rows = graphic.height() / kHeight;
+  std::vector<int> matches(cols * rows);
+  ParallelFor(0, rows, [&](int row) {
+    uint8_t block[GlyphMatcher::kSize];
+    for (int col = 0; col < cols; ++col) {
+      for (int y = 0; y < kHeight; ++y) {
+        for (int x = 0; x < kWidth; ++x) {
+          const Pixel& pix = graphic.Get(col * kWidth + x, row * kHeight + y);
+          int level = ToByte(pix.grey());
+          block[y * kWidth + x] = invert ? 255 - level : level;
+        }
+      }
+      matches[row * cols + col] = matcher.Match(block);
+    }
+  });
+  std::wstring line(cols, L' ');
+  for (int row = 0; row < rows; ++row) {
+    for (int col = 0; col < cols; ++col) {
+      line[col] = matcher.glyph(matches[row * cols + col]);
+    }
+    os << line << "\n";
+  }
+}
+
+// For Emacs:
+// Local Variables:
+// mode:c++
+// indent-tabs-mode:nil
+// tab-width:2
+// c-basic-offset:2
+// c-file-style: nil
+// End:
+// For VIM:
+// vim:set expandtab softtabstop=2 shiftwidth=2 tabstop=2:
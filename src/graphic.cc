@@ -6,6 +6,7 @@
 #include <algorithm>
 #include <iostream>
 #include <glog/logging.h>
+#include "hiptext/parallel.h"
 #include "hiptext/pixel.h"
 
 // Calculate number that's percent between p1 and p2.
@@ -18,6 +19,8 @@ Graphic Graphic::BilinearScale(int new_width, int new_height) const {
     return *this;
   }
   Graphic res(new_width, new_height);
+  res.opaque_ = opaque_;
+  res.premultiplied_ = premultiplied_;
   double rx = static_cast<double>(width_) / res.width_;
   double ry = static_cast<double>(height_) / res.height_;
   for (int y = 0; y < res.height_; ++y) {
@@ -97,24 +100,94 @@ Graphic& Graphic::Equalize() {
 }
 
 Graphic& Graphic::Overlay(Graphic graphic, int offset_x, int offset_y) {
-  for (int y1 = offset_y, y2 = 0;
-       y1 < height_ && y2 < graphic.height_;
-       ++y1, ++y2) {
-    for (int x1 = offset_x, x2 = 0;
-         x1 < width_ && x2 < graphic.width_;
-         ++x1, ++x2) {
-      Get(x1, y1).Overlay(graphic.Get(x2, y2));
+  DCHECK(!premultiplied_ && !graphic.premultiplied_);
+  const int x1 = std::max(0, offset_x);
+  const int x2 = std::min(width_, offset_x + graphic.width_);
+  if (x1 >= x2) {
+    return *this;
+  }
+  for (int y = std::max(0, offset_y);
+       y < height_ && y - offset_y < graphic.height_;
+       ++y) {
+    Pixel* dst = &Get(x1, y);
+    const Pixel* src = &graphic.Get(x1 - offset_x, y - offset_y);
+    if (graphic.opaque_) {
+      std::copy(src, src + (x2 - x1), dst);
+      continue;
+    }
+    // Blending by alpha on every pixel, whatever it is, costs less than
+    // guessing which pixels need it.
+    for (int n = 0; n < x2 - x1; ++n) {
+      const double a = src[n].alpha();
+      const double b = 1.0 - a;
+      dst[n] = Pixel(dst[n].red() * b + src[n].red() * a,
+                     dst[n].green() * b + src[n].green() * a,
+                     dst[n].blue() * b + src[n].blue() * a,
+                     dst[n].alpha() * b + a);
     }
   }
   return *this;
 }
 
 Graphic& Graphic::Opacify(const Pixel& background) {
-  for (int y = 0; y < height_; ++y) {
+  DCHECK_EQ(1.0, background.alpha());
+  if (opaque_) {
+    return *this;
+  }
+  // Straight colors get scaled by alpha here, premultiplied ones already
+  // were. Either way it's one multiply-add per channel with no branches.
+  const bool premultiplied = premultiplied_;
+  ParallelFor(0, height_, [&](int y) {
+    Pixel* row = &pixels_[y * width_];
     for (int x = 0; x < width_; ++x) {
-      Get(x, y).Opacify(background);
+      const double a = row[x].alpha();
+      const double s = premultiplied ? 1.0 : a;
+      const double b = 1.0 - a;
+      row[x] = Pixel(row[x].red() * s + background.red() * b,
+                     row[x].green() * s + background.green() * b,
+                     row[x].blue() * s + background.blue() * b,
+                     1.0);
     }
+  });
+  opaque_ = true;
+  premultiplied_ = false;
+  return *this;
+}
+
+Graphic& Graphic::Premultiply() {
+  if (premultiplied_) {
+    return *this;
+  }
+  if (!opaque_) {
+    ParallelFor(0, height_, [&](int y) {
+      Pixel* row = &pixels_[y * width_];
+      for (int x = 0; x < width_; ++x) {
+        const double a = row[x].alpha();
+        row[x] = Pixel(row[x].red() * a, row[x].green() * a,
+                       row[x].blue() * a, a);
+      }
+    });
   }
+  premultiplied_ = true;
+  return *this;
+}
+
+Graphic& Graphic::Unpremultiply() {
+  if (!premultiplied_) {
+    return *this;
+  }
+  if (!opaque_) {
+    ParallelFor(0, height_, [&](int y) {
+      Pixel* row = &pixels_[y * width_];
+      for (int x = 0; x < width_; ++x) {
+        const double a = row[x].alpha();
+        const double s = a > 0.0 ? 1.0 / a : 0.0;
+        row[x] = Pixel(row[x].red() * s, row[x].green() * s,
+                       row[x].blue() * s, a);
+      }
+    });
+  }
+  premultiplied_ = false;
   return *this;
 }
 
@@ -154,9 +227,27 @@ Graphic& Graphic::FromHSV() {
   return *this;
 }
 
+Graphic& Graphic::ToLinear() {
+  ParallelFor(0, height_, [&](int y) {
+    for (int x = 0; x < width_; ++x) {
+      Get(x, y).ToLinear();
+    }
+  });
+  return *this;
+}
+
+Graphic& Graphic::FromLinear() {
+  ParallelFor(0, height_, [&](int y) {
+    for (int x = 0; x < width_; ++x) {
+      Get(x, y).FromLinear();
+    }
+  });
+  return *this;
+}
+
 Pixel Graphic::GetAverageColor(int x, int y, int w, int h) const {
-  CHECK(0 <= x && x + w < width_);
-  CHECK(0 <= y && y + h < height_);
+  CHECK(0 <= x && 0 < w && x + w <= width_);
+  CHECK(0 <= y && 0 < h && y + h <= height_);
   double avg_red = 0.0;
   double avg_green = 0.0;
   double avg_blue = 0.0;
@@ -167,9 +258,8 @@ Pixel Graphic::GetAverageColor(int x, int y, int w, int h) const {
       avg_blue += Get(x + dx, y + dy).blue();
     }
   }
-  return Pixel(avg_red / (width_ * height_),
-               avg_green / (width_ * height_),
-               avg_blue / (width_ * height_));
+  const double area = static_cast<double>(w) * h;
+  return Pixel(avg_red / area, avg_green / area, avg_blue / area);
 }
 
 // For Emacs:
@@ -1,42 +1,67 @@
 // hiptext - Image to Text Converter
 // By Justine Tunney
 
+#include <algorithm>
 #include <cassert>
 #include <cstdio>
 #include <fstream>
+#include <functional>
 #include <iostream>
 #include <iterator>
 #include <locale>
 #include <memory>
 #include <string>
 #include <sstream>
+#include <vector>
 
 #include <gflags/gflags.h>
 #include <glog/logging.h>
 
 #include "hiptext/artiste.h"
 #include "hiptext/charquantizer.h"
+#include "hiptext/dither.h"
+#include "hiptext/edges.h"
 #include "hiptext/font.h"
+#include "hiptext/glyphmatcher.h"
 #include "hiptext/jpeg.h"
 #include "hiptext/pixel.h"
 #include "hiptext/png.h"
 #include "hiptext/macterm.h"
 #include "hiptext/movie.h"
+#include "hiptext/rendercache.h"
+#include "hiptext/termpalette.h"
 #include "hiptext/xterm256.h"
 #include "hiptext/termprinter.h"
-#include "hiptext/sixelprinter.h"
+#include "hiptext/kittyrenderer.h"
+#include "hiptext/sixelrenderer.h"
+#include "hiptext/subcell.h"
+#include "hiptext/termraster.h"
 #include "hiptext/unicode.h"
 
 using std::cout;
 using std::string;
 using std::wstring;
 
+DECLARE_bool(termpalette);
+
 DEFINE_string(chars, u8"\u00a0\u2591\u2592\u2593\u2588",
               "The quantization character array");
 DEFINE_bool(color, true, "Use --nocolor to disable color altogether");
+DEFINE_bool(glyphs, false, "With --nocolor, choose characters by how well "
+            "their shapes match the image rather than by brightness alone");
+DEFINE_bool(edges, false, "With --nocolor, draw lines along the edges in the "
+            "image with --edge_chars, so outlines and text stay legible at "
+            "small sizes");
 DEFINE_bool(macterm, false, "Optimize for Mac OS X Terminal.app");
 DEFINE_bool(xterm256, true, "Enable xterm-256color output");
 DEFINE_bool(xterm256unicode, false, "Enable xterm256 double-pixel hack");
+DEFINE_bool(truecolor, false, "Use 24-bit color escape codes rather than the "
+            "256 color palette in --xterm256 and --xterm256unicode modes. Most "
+            "modern terminals support this");
+DEFINE_int32(truecolor_bits, 8, "Bits of precision per color channel in "
+             "--truecolor mode. Using fewer bits makes it more likely that "
+             "neighboring cells share the same escape code, which means less "
+             "output");
 DEFINE_string(bg, "black", "The native background of your terminal specified "
               "as a CSS or X11 color value. If you're a real hacker this will "
               "be black, but some insane desktops like to coerce people into "
@@ -52,77 +77,80 @@ DEFINE_bool(spectrum, false, "Show color spectrum graph");
 DEFINE_bool(sixel256, false, "Use sixel graphics (256 colors)");
 DEFINE_bool(sixel16, false, "Use sixel graphics (16 colors)");
 DEFINE_bool(sixel2, false, "Use sixel graphics (2 colors)");
+DEFINE_bool(quadrants, false, "Draw four pixels in each character cell with "
+            "quadrant block characters");
+DEFINE_bool(sextants, false, "Draw six pixels in each character cell with "
+            "the sextant characters added in Unicode 13");
+DEFINE_bool(braille, false, "Draw eight pixels in each character cell with "
+            "braille patterns");
+DEFINE_bool(kitty, false, "Use the kitty graphics protocol, which shows "
+            "images in full color at full resolution");
+DEFINE_bool(progressive, false, "Show progressive JPEGs as they're decoded, "
+            "refining the image in place after each scan. This gives a quick "
+            "preview of huge images on slow storage");
+DEFINE_string(png_out, "", "Write a still image's text rendering to this PNG "
+              "file, drawn with --font as a terminal would show it, rather "
+              "than printing it. Works without a terminal");
+DEFINE_string(cache_dir, "", "Directory in which to cache rendered images, so "
+              "printing the same image at the same size with the same flags "
+              "doesn't have to decode, scale and quantize it again. Disabled "
+              "when empty");
+DEFINE_int32(cache_size, 64, "Maximum size of --cache_dir in megabytes. Least "
+             "recently used entries are evicted first");
 
 static const wchar_t kUpperHalfBlock = L'\u2580';
 
-// 256 color SIXEL is supported by RLogin, mlterm(X11/fb), and tanasinn.
-// xterm with the option "-ti vt340" is limited up to 16 colors.
-void PrintImageSixel256(std::ostream& os, const Graphic& graphic) {
-  Pixel bg = Pixel(FLAGS_bg);
-  SixelPrinter out(os, 256, false, FLAGS_bgprint, rgb_to_xterm256(bg));
-  int width = graphic.width();
-  int height = graphic.height();
-  uint8_t (*to_index)(const Pixel&) = rgb_to_xterm256;
-
-  out.Start();
-  for (int y = 0; y < height; ++y) {
-    for (int x = 0; x < width; ++x) {
-      int code = to_index(graphic.Get(x, y).Copy().Opacify(bg));
-      out.PrintPixel(code);
-    }
-    out.LineFeed();
-  }
-  out.End();
-}
-
-// 16 color SIXEL is supported by xterm with the option "-ti vt340"
-void PrintImageSixel16(std::ostream& os, const Graphic& graphic) {
+void PrintImageXterm256(std::ostream& os, const Graphic& graphic) {
+  TermPrinter out(os);
   Pixel bg = Pixel(FLAGS_bg);
-  SixelPrinter out(os, 16, false, FLAGS_bgprint, rgb_to_xterm16(bg));
-  int width = graphic.width();
-  int height = graphic.height();
-  uint8_t (*to_index)(const Pixel&) = rgb_to_xterm16;
-
-  out.Start();
-  for (int y = 0; y < height; ++y) {
-    for (int x = 0; x < width; ++x) {
-      int code = to_index(graphic.Get(x, y).Copy().Opacify(bg));
-      out.PrintPixel(code);
+  int bg256 = rgb_to_xterm256(bg);
+  Ditherer ditherer(GetDitherMode(), PerPixel(rgb_to_xterm256),
+                    g_xterm, 16, 256);
+  std::vector<uint8_t> codes(graphic.width());
+  for (int y = 0; y < graphic.height(); ++y) {
+    ditherer.QuantizeRow(graphic, y, codes.data());
+    for (int x = 0; x < graphic.width(); ++x) {
+      int code = codes[x];
+      if (!FLAGS_bgprint && code == bg256) {
+        out.SetBackground256(0);
+      } else {
+        out.SetBackground256(code);
+      }
+      out << FLAGS_space;
     }
-    out.LineFeed();
+    out.Reset();
+    out << "\n";
   }
-  out.End();
 }
 
-void PrintImageSixel2(std::ostream& os, const Graphic& graphic) {
-  Pixel bg = Pixel(FLAGS_bg);
-  SixelPrinter out(os, 2, false, false, 0);
-  int width = graphic.width();
-  int height = graphic.height();
-  uint8_t (*to_index)(const Pixel&) = rgb_to_xterm16;
-
-  out.Start();
-  for (int y = 0; y < height; ++y) {
-    for (int x = 0; x < width; ++x) {
-      int code = to_index(graphic.Get(x, y).Copy().Opacify(bg));
-      out.PrintPixel(code);
-    }
-    out.LineFeed();
+// Quantizes 8-bit channels to --truecolor_bits while still spanning 0..255.
+static void MakeTrueColorLevels(uint8_t levels[256]) {
+  int bits = std::max(1, std::min(8, FLAGS_truecolor_bits));
+  int max = (1 << bits) - 1;
+  for (int n = 0; n < 256; ++n) {
+    levels[n] = ((n >> (8 - bits)) * 255 + max / 2) / max;
   }
-  out.End();
 }
 
-void PrintImageXterm256(std::ostream& os, const Graphic& graphic) {
+void PrintImageTrueColor(std::ostream& os, const Graphic& graphic) {
   TermPrinter out(os);
   Pixel bg = Pixel(FLAGS_bg);
-  int bg256 = rgb_to_xterm256(bg);
+  uint8_t levels[256];
+  MakeTrueColorLevels(levels);
+  int bg_red = levels[ToByte(bg.red())];
+  int bg_green = levels[ToByte(bg.green())];
+  int bg_blue = levels[ToByte(bg.blue())];
   for (int y = 0; y < graphic.height(); ++y) {
     for (int x = 0; x < graphic.width(); ++x) {
-      int code = rgb_to_xterm256(graphic.Get(x, y).Copy().Opacify(bg));
-      if (!FLAGS_bgprint && code == bg256) {
+      const Pixel& pixel = graphic.Get(x, y);
+      int red = levels[ToByte(pixel.red())];
+      int green = levels[ToByte(pixel.green())];
+      int blue = levels[ToByte(pixel.blue())];
+      if (!FLAGS_bgprint &&
+          red == bg_red && green == bg_green && blue == bg_blue) {
         out.SetBackground256(0);
       } else {
-        out.SetBackground256(code);
+        out.SetBackgroundRGB(red, green, blue);
       }
       out << FLAGS_space;
     }
@@ -131,17 +159,42 @@ void PrintImageXterm256(std::ostream& os, const Graphic& graphic) {
   }
 }
 
-void PrintImageXterm256Unicode(std::ostream& os, const Graphic& graphic) {
+void PrintImageTrueColorUnicode(std::ostream& os, const Graphic& graphic) {
   TermPrinter out(os);
+  uint8_t levels[256];
+  MakeTrueColorLevels(levels);
   int height = graphic.height() - graphic.height() % 2;
   for (int y = 0; y < height; y += 2) {
     for (int x = 0; x < graphic.width(); ++x) {
       const Pixel& top = graphic.Get(x, y);
       const Pixel& bottom = graphic.Get(x, y + 1);
-      int top256 = rgb_to_xterm256(top);
-      int bottom256 = rgb_to_xterm256(bottom);
-      out.SetForeground256(top256);
-      out.SetBackground256(bottom256);
+      out.SetForegroundRGB(levels[ToByte(top.red())],
+                           levels[ToByte(top.green())],
+                           levels[ToByte(top.blue())]);
+      out.SetBackgroundRGB(levels[ToByte(bottom.red())],
+                           levels[ToByte(bottom.green())],
+                           levels[ToByte(bottom.blue())]);
+      out << kUpperHalfBlock;
+    }
+    out.Reset();
+    out << "\n";
+  }
+}
+
+void PrintImageXterm256Unicode(std::ostream& os, const Graphic& graphic) {
+  TermPrinter out(os);
+  int width = graphic.width();
+  int height = graphic.height() - graphic.height() % 2;
+  Ditherer ditherer(GetDitherMode(), PerPixel(rgb_to_xterm256),
+                    g_xterm, 16, 256);
+  std::vector<uint8_t> top(width);
+  std::vector<uint8_t> bottom(width);
+  for (int y = 0; y < height; y += 2) {
+    ditherer.QuantizeRow(graphic, y, top.data());
+    ditherer.QuantizeRow(graphic, y + 1, bottom.data());
+    for (int x = 0; x < width; ++x) {
+      out.SetForeground256(top[x]);
+      out.SetBackground256(bottom[x]);
       out << kUpperHalfBlock;
     }
     out.Reset();
@@ -151,12 +204,10 @@ void PrintImageXterm256Unicode(std::ostream& os, const Graphic& graphic) {
 
 void PrintImageMacterm(std::ostream& os, const Graphic& graphic) {
   TermPrinter out(os);
-  Pixel bg = Pixel(FLAGS_bg);
   int height = graphic.height() - graphic.height() % 2;
   for (int y = 0; y < height; y += 2) {
     for (int x = 0; x < graphic.width(); ++x) {
-      MactermColor color(graphic.Get(x, y + 0).Copy().Opacify(bg),
-                         graphic.Get(x, y + 1).Copy().Opacify(bg));
+      MactermColor color(graphic.Get(x, y + 0), graphic.Get(x, y + 1));
       out.SetForeground256(color.fg());
       out.SetBackground256(color.bg());
       out << color.symbol();
@@ -167,19 +218,19 @@ void PrintImageMacterm(std::ostream& os, const Graphic& graphic) {
 }
 
 void PrintImageNoColor(std::ostream& os, const Graphic& graphic) {
-  Pixel bg = Pixel(FLAGS_bg);
+  bool invert = HasLightBackground();
   wstring chars = DecodeText(FLAGS_chars);
   CharQuantizer quantizer(chars, 256);
   for (int y = 0; y < graphic.height(); ++y) {
     for (int x = 0; x < graphic.width(); ++x) {
       const Pixel& pixel = graphic.Get(x, y);
-      if (bg == Pixel::kWhite) {
+      if (invert) {
         os << quantizer.Quantize(255 - static_cast<int>(pixel.grey() * 255));
       } else {
         os << quantizer.Quantize(static_cast<int>(pixel.grey() * 255));
       }
     }
-    cout << "\n";
+    os << "\n";
   }
 }
 
@@ -194,6 +245,36 @@ inline string GetExtension(const string& path) {
   return s;
 }
 
+// Prints a still image, consulting --cache_dir before calling 'load'.
+void PrintImageFile(Artiste* artiste, const string& path,
+                    std::function<Graphic()> load) {
+  if (!FLAGS_png_out.empty()) {
+    TermGrid grid;
+    grid.Write(artiste->RenderImage(load()));
+    WritePNG(RasterizeTerminal(grid), FLAGS_png_out);
+    return;
+  }
+  if (FLAGS_cache_dir.empty() || !artiste->replayable()) {
+    artiste->PrintImage(load());
+    return;
+  }
+  RenderCache cache(FLAGS_cache_dir,
+                    static_cast<int64_t>(FLAGS_cache_size) << 20);
+  std::ostringstream salt;
+  salt << artiste->term_width() << "x" << artiste->term_height() << "\n"
+       << google::CommandlineFlagsIntoString();
+  string key = cache.Key(path, salt.str());
+  cout.flush();
+  if (!key.empty() && cache.Replay(key, fileno(stdout))) {
+    return;
+  }
+  string rendered = artiste->RenderImage(load());
+  cout << rendered;
+  if (!key.empty()) {
+    cache.Store(key, rendered);
+  }
+}
+
 int main(int argc, char** argv) {
   // if (!isatty(1))
   //   FLAGS_color = false;
@@ -209,31 +290,73 @@ int main(int argc, char** argv) {
   Movie::InitializeMain();
 
   RenderAlgorithm algo;
-  bool duo_pixel = false;
+  int cell_width = 1;
+  int cell_height = 1;
   if (FLAGS_color) {
-    if (FLAGS_xterm256unicode) {
+    if (FLAGS_braille) {
+      algo = PrintImageBraille;
+      cell_width = 2;
+      cell_height = 4;
+    } else if (FLAGS_sextants) {
+      algo = PrintImageSextants;
+      cell_width = 2;
+      cell_height = 3;
+    } else if (FLAGS_quadrants) {
+      algo = PrintImageQuadrants;
+      cell_width = 2;
+      cell_height = 2;
+    } else if (FLAGS_xterm256unicode && FLAGS_truecolor) {
+      algo = PrintImageTrueColorUnicode;
+      cell_height = 2;
+    } else if (FLAGS_xterm256unicode) {
       algo = PrintImageXterm256Unicode;
-      duo_pixel = true;
+      cell_height = 2;
     } else if (FLAGS_macterm) {
       algo = PrintImageMacterm;
-      duo_pixel = true;
+      cell_height = 2;
+    } else if (FLAGS_kitty) {
+      algo = KittyRenderer();
+      cell_height = 2;
     } else if (FLAGS_sixel2) {
-      algo = PrintImageSixel2;
-      duo_pixel = true;
+      algo = SixelRenderer(2);
+      cell_height = 2;
     } else if (FLAGS_sixel16) {
-      algo = PrintImageSixel16;
-      duo_pixel = true;
+      algo = SixelRenderer(16);
+      cell_height = 2;
     } else if (FLAGS_sixel256) {
-      algo = PrintImageSixel256;
-      duo_pixel = true;
+      algo = SixelRenderer(256);
+      cell_height = 2;
+    } else if (FLAGS_truecolor) {
+      algo = PrintImageTrueColor;
     } else {
       algo = PrintImageXterm256;
     }
+  } else if (FLAGS_glyphs) {
+    algo = PrintImageGlyphs;
+    cell_width = GlyphMatcher::kWidth;
+    cell_height = GlyphMatcher::kHeight;
+  } else if (FLAGS_edges) {
+    algo = PrintImageEdges;
+    cell_width = kEdgeCellWidth;
+    cell_height = kEdgeCellHeight;
   } else {
     algo = PrintImageNoColor;
   }
-  Artiste artiste(std::cout, std::cin, algo, duo_pixel,
-                  FLAGS_sixel2 || FLAGS_sixel16 || FLAGS_sixel256);
+  bool pixel_mode = FLAGS_color && (FLAGS_kitty || FLAGS_sixel2 ||
+                                    FLAGS_sixel16 || FLAGS_sixel256);
+  // SIXEL defines its own colors, MacTerm has a fixed palette and true color
+  // doesn't use one, so only the xterm modes care what the terminal's are.
+  if (FLAGS_termpalette && FLAGS_color && !FLAGS_truecolor && !FLAGS_macterm &&
+      !pixel_mode) {
+    LoadTerminalPalette();
+  }
+  Artiste artiste(std::cout, std::cin, algo, cell_width, cell_height,
+                  pixel_mode);
+  if (FLAGS_color && FLAGS_kitty) {
+    artiste.set_replayable(KittyOutputIsReplayable());
+    // Kitty blends transparent pixels with whatever is behind the window.
+    artiste.set_opacify(FLAGS_bgprint);
+  }
 
   // Did they specify an option that requires no args?
   if (FLAGS_spectrum) {
@@ -250,10 +373,25 @@ int main(int argc, char** argv) {
   }
   string path = argv[1];
   string extension = GetExtension(path);
+  if (!FLAGS_png_out.empty() &&
+      (pixel_mode || (extension != "png" && extension != "jpg" &&
+                      extension != "jpeg"))) {
+    fprintf(stderr, "--png_out only works with text modes and PNG or JPEG "
+            "images.\n");
+    exit(1);
+  }
   if (extension == "png") {
-    artiste.PrintImage(LoadPNG(path));
+    PrintImageFile(&artiste, path, [&]() { return LoadPNG(path); });
+  } else if ((extension == "jpg" || extension == "jpeg") &&
+             FLAGS_progressive && FLAGS_png_out.empty()) {
+    LoadJPEGProgressive(path, [&](Graphic graphic) {
+      artiste.RepaintImage(std::move(graphic));
+    });
   } else if (extension == "jpg" || extension == "jpeg") {
-    artiste.PrintImage(LoadJPEG(path));
+    PrintImageFile(&artiste, path, [&]() { return LoadJPEG(path); });
+  } else if (extension == "gif" || extension == "webp" ||
+             extension == "bmp" || extension == "tif" || extension == "tiff") {
+    artiste.PrintAnimation(Movie(path));
   } else if (extension == "mov" || extension == "mp4" || extension == "flv" ||
              extension == "avi" || extension == "mkv") {
     artiste.PrintMovie(Movie(path));
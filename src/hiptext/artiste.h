@@ -6,40 +6,84 @@
 
 #include <functional>
 #include <ostream>
+#include <string>
 
 #include "hiptext/unicode.h"
 
-class Movie;
 class Graphic;
+class Movie;
+class ReplayCache;
 
 using RenderAlgorithm = std::function<void(std::ostream&, const Graphic&)>;
 
+// Whether a movie or animation is playing. Each frame is then drawn from the
+// top left corner of the screen over the previous one, which lets renderers
+// send only what changed and avoid choices that would make frames flicker.
+bool IsPlayingVideo();
+void SetPlayingVideo(bool playing);
+
+// Gets the size of a character cell in pixels, if the terminal says.
+bool GetCellSize(int* width, int* height);
+
+// Makes GetCellSize() report this size instead, until called with zeros.
+void SetCellSize(int width, int height);
+
+// Whether --bg is closer to white than black. Modes that draw characters in
+// ink where the image is bright should then draw them where it's dark.
+bool HasLightBackground();
+
 class Artiste {  // The one who lives in your terminal.
  public:
+  // 'cell_width' by 'cell_height' is how many pixels of the image the
+  // algorithm draws in each character cell. In 'pixel_mode', the terminal is
+  // measured in real pixels and 1x2 means those are drawn as they are.
   Artiste(std::ostream& output, std::istream& input,
-          RenderAlgorithm algorithm, bool duopixel, bool use_sixel);
+          RenderAlgorithm algorithm, int cell_width, int cell_height,
+          bool pixel_mode);
   // The Artiste refuses such mimicry. (As expected of a hippy.)
   Artiste(const Artiste& a) = delete;
   void operator=(const Artiste& a) = delete;
 
   void PrintImage(Graphic graphic);
+  std::string RenderImage(Graphic graphic);  // Like PrintImage() but buffered.
+  void RepaintImage(Graphic graphic);  // Draws over the last RepaintImage().
   void PrintMovie(Movie movie);
+  void PrintAnimation(Movie movie);  // For GIF, WebP, etc.
 
   void GenerateSpectrum();
 
   inline int term_width() const { return term_width_; }
   inline int term_height() const { return term_height_; }
 
+  // Whether output can be saved and written to the terminal again later,
+  // which isn't so if the algorithm hands pixels over out of band.
+  inline bool replayable() const { return replayable_; }
+  inline void set_replayable(bool replayable) { replayable_ = replayable; }
+
+  // Whether images are composited onto --bg before the algorithm sees them,
+  // so it can take every pixel as opaque. Algorithms that hand alpha on to
+  // the terminal turn this off, and get straight alpha instead.
+  inline bool opacify() const { return opacify_; }
+  inline void set_opacify(bool opacify) { opacify_ = opacify; }
+
   void ShowCursor();
   void HideCursor();
   void ResetCursor();
 
  private:
   void ComputeDimensions(double media_ratio);
+  Graphic Prepare(Graphic graphic);
+  Graphic Scale(const Graphic& graphic) const;  // Per --scaler.
+  // 'delay' is how many seconds the frame is shown for, for 'replay'.
+  void PrintFrame(const Graphic& graphic, double delay, ReplayCache* replay);
+  std::string RenderFrame(const Graphic& graphic);  // Buffered PrintFrame().
 
   std::ostream& output_;
   RenderAlgorithm algorithm_;
-  bool duo_pixel_;  // Some algorithms improve vertical resolution.
+  int cell_width_;  // Some algorithms draw more than one pixel per cell.
+  int cell_height_;
+  bool replayable_ = true;
+  bool opacify_ = true;
 
   int term_width_;
   int term_height_;
@@ -49,6 +93,7 @@ class Artiste {  // The one who lives in your terminal.
   int height_ = -1;
 
   bool cursor_saved_ = false;
+  int repaint_lines_ = -1;  // Newlines printed by the last RepaintImage().
 };
 
 #endif  // HIPTEXT_ARTISTE_H_
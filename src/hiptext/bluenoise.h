@@ -0,0 +1,25 @@
+// hiptext - Image to Text Converter
+// By Justine Tunney
+
+#ifndef HIPTEXT_BLUENOISE_H_
+#define HIPTEXT_BLUENOISE_H_
+
+#include <cstdint>
+
+// A 64x64 tile of blue noise, made with Ulichney's void-and-cluster method.
+// Each entry is its rank from 0 to 4095. Lighting every pixel ranked below n
+// gives an even pattern of n dots, even across the seams between tiles.
+extern const uint16_t g_blue_noise[64][64];
+
+#endif  // HIPTEXT_BLUENOISE_H_
+
+// For Emacs:
+// Local Variables:
+// mode:c++
+// indent-tabs-mode:nil
+// tab-width:2
+// c-basic-offset:2
+// c-file-style: nil
+// End:
+// For VIM:
+// vim:set expandtab softtabstop=2 shiftwidth=2 tabstop=2:
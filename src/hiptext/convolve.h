@@ -0,0 +1,74 @@
+// hiptext - Image to Text Converter
+// By Justine Tunney
+
+#ifndef HIPTEXT_CONVOLVE_H_
+#define HIPTEXT_CONVOLVE_H_
+
+#include <vector>
+
+#include <glog/logging.h>
+
+class Graphic;
+
+// A single channel of floats, packed row by row, for filtering.
+class Plane {
+ public:
+  Plane(int width, int height)
+      : width_(width), height_(height), data_(width * height) {}
+
+  inline int width() const { return width_; }
+  inline int height() const { return height_; }
+
+  inline float* row(int y) { return &data_[y * width_]; }
+  inline const float* row(int y) const { return &data_[y * width_]; }
+
+  inline float& Get(int x, int y) {
+    DCHECK(0 <= x && x < width_ && 0 <= y && y < height_);
+    return data_[y * width_ + x];
+  }
+  inline float Get(int x, int y) const {
+    DCHECK(0 <= x && x < width_ && 0 <= y && y < height_);
+    return data_[y * width_ + x];
+  }
+
+ private:
+  int width_;
+  int height_;
+  std::vector<float> data_;
+};
+
+// The grey level of each pixel, from zero to one.
+Plane GreyPlane(const Graphic& graphic);
+
+// Filters 'src' with 'horizontal' along rows and then 'vertical' down
+// columns. Kernels have an odd length and are applied as written, without
+// flipping, so {-1, 0, 1} is positive where values rise to the right. Pixels
+// past the edge repeat the nearest one. Rows are split across threads and
+// SSE does four pixels at a time.
+Plane ConvolveSeparable(const Plane& src, const std::vector<float>& horizontal,
+                        const std::vector<float>& vertical);
+
+// Normalized Gaussian kernel reaching three standard deviations out.
+std::vector<float> GaussianKernel(double sigma);
+
+Plane GaussianBlur(const Plane& src, double sigma);
+
+// Unsharp mask: pushes each pixel away from its blurred neighborhood.
+Plane Sharpen(const Plane& src, double sigma, double amount);
+
+// Sobel gradients, where 'gx' is positive where it gets brighter to the right
+// and 'gy' where it gets brighter going down.
+void Sobel(const Plane& src, Plane* gx, Plane* gy);
+
+#endif  // HIPTEXT_CONVOLVE_H_
+
+// For Emacs:
+// Local Variables:
+// mode:c++
+// indent-tabs-mode:nil
+// tab-width:2
+// c-basic-offset:2
+// c-file-style: nil
+// End:
+// For VIM:
+// vim:set expandtab softtabstop=2 shiftwidth=2 tabstop=2:
@@ -0,0 +1,98 @@
+// hiptext - Image to Text Converter
+// By Justine Tunney
+
+#ifndef HIPTEXT_DITHER_H_
+#define HIPTEXT_DITHER_H_
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "hiptext/pixel.h"
+
+class Graphic;
+
+enum class DitherMode {
+  kNone,            // Nearest color only.
+  kFloydSteinberg,  // Error diffusion to four neighbors.
+  kSierraLite,      // Error diffusion to three neighbors. Slightly faster.
+  kBayer,           // Ordered, using an 8x8 Bayer matrix.
+  kBlueNoise,       // Ordered, using a 64x64 void-and-cluster texture.
+};
+
+// Parses a mode name like "floyd". Dies if it isn't recognized.
+DitherMode ParseDitherMode(const std::string& name);
+
+// Returns the mode chosen with --dither. While video is playing, error
+// diffusion is swapped for --video_dither, since it would make the whole
+// frame shimmer whenever anything in it changes.
+DitherMode GetDitherMode();
+
+// Maps the pixels of an image to palette indices, spreading quantization
+// error so gradients don't band.
+//
+// Rows are loaded as packed 8-bit RGB and handed to the quantizer whole.
+// Error diffusion walks them in order, carrying integer error from one row to
+// the next. The ordered modes add a threshold from a tiled matrix instead,
+// which makes every row independent.
+class Ditherer {
+ public:
+  // Stores the palette index of each of the 'width' pixels at 'rgb' in 'out'.
+  using Quantizer =
+      std::function<void(const uint8_t* rgb, int width, uint8_t* out)>;
+
+  // 'quantize' returns indices into 'palette', and will only ever return
+  // indices in [begin, end).
+  Ditherer(DitherMode mode, Quantizer quantize,
+           const Pixel* palette, int begin, int end);
+  Ditherer(const Ditherer& other) = delete;
+  void operator=(const Ditherer& other) = delete;
+
+  // Stores the palette index of each pixel in row 'y' in 'out'. Images are
+  // taken to be opaque. With error diffusion the rows of a frame must be
+  // asked for from the top down, since each carries error into the next.
+  // Ordered rows can come in any order, from several threads at once.
+  void QuantizeRow(const Graphic& graphic, int y, uint8_t* out);
+
+  // Returns the palette index of each pixel in row major order, quantizing
+  // ordered rows in parallel. SIXEL wants the whole frame, since it compares
+  // it with the last one and encodes its bands in parallel.
+  std::vector<uint8_t> Quantize(const Graphic& graphic);
+
+ private:
+  void Diffuse(const Graphic& graphic, int y, uint8_t* out);
+  void Order(const Graphic& graphic, int y, uint8_t* out) const;
+
+  DitherMode mode_;
+  Quantizer quantize_;
+  uint8_t palette_[256][3];
+  std::vector<int16_t> offsets_;  // Ordered thresholds, scaled per channel.
+  int offset_rows_ = 0;
+  std::vector<int> cur_;          // Error diffused into this row and the next.
+  std::vector<int> next_;
+};
+
+// Makes a Quantizer out of a function that maps one Pixel to a palette index,
+// calling it directly from the loop over each row.
+template <typename Function>
+Ditherer::Quantizer PerPixel(Function quantize) {
+  return [quantize](const uint8_t* rgb, int width, uint8_t* out) {
+    for (int x = 0; x < width; ++x, rgb += 3) {
+      out[x] = quantize(Pixel(rgb[0], rgb[1], rgb[2]));
+    }
+  };
+}
+
+#endif  // HIPTEXT_DITHER_H_
+
+// For Emacs:
+// Local Variables:
+// mode:c++
+// indent-tabs-mode:nil
+// tab-width:2
+// c-basic-offset:2
+// c-file-style: nil
+// End:
+// For VIM:
+// vim:set expandtab softtabstop=2 shiftwidth=2 tabstop=2:
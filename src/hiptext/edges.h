@@ -0,0 +1,35 @@
+// hiptext - Image to Text Converter
+// By Justine Tunney
+
+#ifndef HIPTEXT_EDGES_H_
+#define HIPTEXT_EDGES_H_
+
+#include <ostream>
+
+class Graphic;
+
+// Pixels per character cell with --edges.
+const int kEdgeCellWidth = 4;
+const int kEdgeCellHeight = 8;
+
+// Returns which way the lines run in a patch whose Sobel gradients sum to
+// 'sxx' (gx squared), 'syy' and 'sxy': 0 is horizontal, 1 falls to the
+// right, 2 is vertical and 3 rises to the right, like "-\|/".
+int EdgeOrientation(double sxx, double syy, double sxy);
+
+// Like PrintImageNoColor, except cells that an edge runs through get a line
+// from --edge_chars pointing along it, for --nocolor --edges.
+void PrintImageEdges(std::ostream& os, const Graphic& graphic);
+
+#endif  // HIPTEXT_EDGES_H_
+
+// For Emacs:
+// Local Variables:
+// mode:c++
+// indent-tabs-mode:nil
+// tab-width:2
+// c-basic-offset:2
+// c-file-style: nil
+// End:
+// For VIM:
+// vim:set expandtab softtabstop=2 shiftwidth=2 tabstop=2:
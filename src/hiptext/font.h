@@ -4,10 +4,54 @@
 #ifndef HIPTEXT_FONT_H_
 #define HIPTEXT_FONT_H_
 
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
 class Graphic;
 class Pixel;
 
+// A glyph drawn into a cell as wide as its advance and as tall as a line,
+// stored as 8-bit coverage row by row in its GlyphAtlas.
+struct Glyph {
+  int width;
+  int height;
+  int baseline;   // Rows from the top of the cell to the baseline.
+  size_t offset;  // Where its coverage starts in the atlas.
+};
+
+// Glyphs rasterized with FreeType, each only once.
+//
+// The first time a character is asked for at some size, it's rendered and
+// its coverage appended to one packed buffer. After that it's a hash probe.
+// Get() only writes when it has to render, so once every glyph needed has
+// been fetched the atlas can be shared between threads.
+class GlyphAtlas {
+ public:
+  GlyphAtlas() = default;
+  GlyphAtlas(const GlyphAtlas& other) = delete;
+  void operator=(const GlyphAtlas& other) = delete;
+
+  // 'size' is in points at --font_dpi, where zero means --font_size.
+  const Glyph& Get(wchar_t letter, int size = 0);
+
+  inline const uint8_t* coverage(const Glyph& glyph) const {
+    return &pixels_[glyph.offset];
+  }
+  inline size_t bytes() const { return pixels_.size(); }
+
+ private:
+  std::unordered_map<uint64_t, Glyph> glyphs_;
+  std::vector<uint8_t> pixels_;
+};
+
 void InitFont();
+
+// Returns the atlas shared by everything that draws text.
+GlyphAtlas& GetGlyphAtlas();
+
+// Draws 'letter' in a cell of its own, blending 'fg' over 'bg' by coverage.
 Graphic LoadLetter(wchar_t letter, const Pixel& fg, const Pixel& bg);
 
 #endif  // HIPTEXT_FONT_H_
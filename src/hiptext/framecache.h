@@ -0,0 +1,55 @@
+// hiptext - Image to Text Converter
+// By Justine Tunney
+
+#ifndef HIPTEXT_FRAMECACHE_H_
+#define HIPTEXT_FRAMECACHE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class Graphic;
+
+// In-memory storage for the decoded frames of an animation.
+//
+// Frames are kept as packed 8-bit RGB rather than as Pixel objects, which are
+// eight times larger, so an animation can be decoded once and then looped
+// from memory. Consecutive identical frames are merged by summing their
+// delays, which is common in GIFs that hold on a frame.
+class FrameCache {
+ public:
+  FrameCache() = default;
+  FrameCache(const FrameCache& other) = delete;
+  void operator=(const FrameCache& other) = delete;
+
+  void Add(const Graphic& graphic, double delay);
+  Graphic Get(int index) const;
+
+  inline double delay(int index) const { return frames_[index].delay; }
+  inline int size() const { return static_cast<int>(frames_.size()); }
+  inline size_t bytes() const { return bytes_; }
+
+ private:
+  struct Frame {
+    std::vector<uint8_t> rgb;
+    double delay;  // Seconds to display this frame.
+  };
+
+  int width_ = 0;
+  int height_ = 0;
+  size_t bytes_ = 0;
+  std::vector<Frame> frames_;
+};
+
+#endif  // HIPTEXT_FRAMECACHE_H_
+
+// For Emacs:
+// Local Variables:
+// mode:c++
+// indent-tabs-mode:nil
+// tab-width:2
+// c-basic-offset:2
+// c-file-style: nil
+// End:
+// For VIM:
+// vim:set expandtab softtabstop=2 shiftwidth=2 tabstop=2:
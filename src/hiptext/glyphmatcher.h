@@ -0,0 +1,62 @@
+// hiptext - Image to Text Converter
+// By Justine Tunney
+
+#ifndef HIPTEXT_GLYPHMATCHER_H_
+#define HIPTEXT_GLYPHMATCHER_H_
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+class Graphic;
+
+// Picks the character whose shape best matches a block of an image.
+//
+// Each glyph in the set is taken from the GlyphAtlas and shrunk to a grid of
+// kWidth by kHeight ink levels, scaled so the inkiest spot in the whole set
+// is 255. A block of grey levels the same size is then matched to
+// the glyph with the smallest sum of absolute differences, which SSE2 works
+// out sixteen levels at a time.
+class GlyphMatcher {
+ public:
+  static const int kWidth = 4;
+  static const int kHeight = 8;
+  static const int kSize = kWidth * kHeight;
+
+  // Renders 'glyphs' with the font, which must have been loaded.
+  explicit GlyphMatcher(const std::wstring& glyphs);
+
+  // Uses 'features', which holds kSize levels for each glyph in turn.
+  GlyphMatcher(const std::wstring& glyphs, std::vector<uint8_t> features);
+
+  // Returns the index of the glyph nearest 'block', which is kSize levels row
+  // by row. Ties go to whichever glyph comes first.
+  int Match(const uint8_t* block) const;
+
+  inline wchar_t glyph(int index) const { return glyphs_[index]; }
+  inline const uint8_t* features(int index) const {
+    return &features_[index * kSize];
+  }
+
+ private:
+  std::wstring glyphs_;
+  std::vector<uint8_t> features_;
+};
+
+// Renders the --glyph_set character that best fits each kWidth by kHeight
+// block of 'graphic', for --nocolor --glyphs.
+void PrintImageGlyphs(std::ostream& os, const Graphic& graphic);
+
+#endif  // HIPTEXT_GLYPHMATCHER_H_
+
+// For Emacs:
+// Local Variables:
+// mode:c++
+// indent-tabs-mode:nil
+// tab-width:2
+// c-basic-offset:2
+// c-file-style: nil
+// End:
+// For VIM:
+// vim:set expandtab softtabstop=2 shiftwidth=2 tabstop=2:
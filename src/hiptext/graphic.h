@@ -21,7 +21,8 @@ class Graphic {
   Graphic(int width, int height, const Pixel& pixel)
     : width_(width),
       height_(height),
-      pixels_(width * height, pixel) {}
+      pixels_(width * height, pixel),
+      opaque_(pixel.alpha() == 1.0) {}
 
   Graphic(int width, int height, std::vector<Pixel>&& pixels)
       : width_(width),
@@ -33,6 +34,21 @@ class Graphic {
   inline int width() const { return width_; }
   inline int height() const { return height_; }
 
+  // Set when every pixel is known to have an alpha of one, which lets
+  // compositing be skipped. Decoders set it for formats without alpha, and
+  // scaling keeps it.
+  inline bool opaque() const { return opaque_; }
+  inline Graphic& set_opaque(bool opaque) { opaque_ = opaque; return *this; }
+
+  // Whether colors have been multiplied by their alpha. Blending those, like
+  // scaling does, can't bleed the colors of invisible pixels into their
+  // neighbors.
+  inline bool premultiplied() const { return premultiplied_; }
+  inline Graphic& set_premultiplied(bool premultiplied) {
+    premultiplied_ = premultiplied;
+    return *this;
+  }
+
   inline Pixel& Get(int x, int y) {
     DCHECK_GE(x, 0);
     DCHECK_LT(x, width_);
@@ -62,18 +78,24 @@ class Graphic {
   Pixel GetAverageColor(int x, int y, int w, int h) const;
   Graphic Copy() const { return *this; }
   Graphic& Overlay(Graphic graphic, int offset_x = 0, int offset_y = 0);
-  Graphic& Opacify(const Pixel& background);
+  Graphic& Opacify(const Pixel& background);  // Straight or premultiplied.
+  Graphic& Premultiply();
+  Graphic& Unpremultiply();
   Graphic BilinearScale(int new_width, int new_height) const;
   Graphic& Equalize();
   Graphic& ToYUV();
   Graphic& FromYUV();
   Graphic& ToHSV();
   Graphic& FromHSV();
+  Graphic& ToLinear();
+  Graphic& FromLinear();
 
  private:
   int width_;
   int height_;
   std::vector<Pixel> pixels_;
+  bool opaque_ = false;
+  bool premultiplied_ = false;
 };
 
 #endif  // HIPTEXT_GRAPHIC_H_
@@ -4,12 +4,22 @@
 #ifndef HIPTEXT_JPEG_H_
 #define HIPTEXT_JPEG_H_
 
+#include <functional>
 #include <string>
 
 class Graphic;
 
 Graphic LoadJPEG(const std::string& path);
 
+// Decodes a JPEG held in memory. Large baseline files with restart markers are
+// split at restart intervals and decoded on multiple threads.
+Graphic DecodeJPEG(const std::string& data);
+
+// Decodes a progressive JPEG one scan at a time, calling 'callback' with the
+// image as it looks after each scan. Baseline files get a single callback.
+void LoadJPEGProgressive(const std::string& path,
+                         const std::function<void(Graphic)>& callback);
+
 #endif  // HIPTEXT_JPEG_H_
 
 // For Emacs:
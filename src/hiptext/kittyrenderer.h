@@ -0,0 +1,51 @@
+// hiptext - Image to Text Converter
+// By Justine Tunney
+
+#ifndef HIPTEXT_KITTYRENDERER_H_
+#define HIPTEXT_KITTYRENDERER_H_
+
+#include <memory>
+#include <ostream>
+
+class Graphic;
+
+// A RenderAlgorithm that draws images with the kitty graphics protocol.
+//
+// Pixels are sent as raw RGBA at full resolution. When the terminal is on the
+// same machine it can read them straight out of a POSIX shared memory object
+// or a temporary file, per --kitty_transfer, so only a name goes down the
+// pty. Otherwise they're sent inline as base64 in chunks.
+//
+// While video is playing, each distinct frame is kept in the terminal under
+// its own image ID. A frame that was seen recently is placed again by ID
+// without sending any pixels, and one that's already on the screen costs
+// nothing at all. The first frame stays for as long as the video plays, so
+// loops can always go back to it.
+class KittyRenderer {
+ public:
+  KittyRenderer();
+
+  void operator()(std::ostream& os, const Graphic& graphic);
+
+ private:
+  struct State;
+
+  std::shared_ptr<State> state_;  // Shared by copies of this functor.
+};
+
+// Returns false if the output names files or shared memory which the terminal
+// deletes once it has read them, in which case it can't be replayed.
+bool KittyOutputIsReplayable();
+
+#endif  // HIPTEXT_KITTYRENDERER_H_
+
+// For Emacs:
+// Local Variables:
+// mode:c++
+// indent-tabs-mode:nil
+// tab-width:2
+// c-basic-offset:2
+// c-file-style: nil
+// End:
+// For VIM:
+// vim:set expandtab softtabstop=2 shiftwidth=2 tabstop=2:
@@ -22,6 +22,8 @@ class MactermColor {
   static const wchar_t kFullBlock = L'\u2588';
   static const wchar_t kSpace = L' ';
 
+  void Compute(const Pixel& top, const Pixel& bot);
+
   uint8_t bg_;
   uint8_t fg_;
   wchar_t symbol_;
@@ -0,0 +1,54 @@
+// hiptext - Image to Text Converter
+// By Justine Tunney
+
+#ifndef HIPTEXT_MEDIANCUT_H_
+#define HIPTEXT_MEDIANCUT_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "hiptext/palette.h"
+#include "hiptext/pixel.h"
+
+class Graphic;
+
+// A palette chosen to suit one particular image.
+//
+// Colors are picked with Heckbert's median cut over a histogram of 5-bit per
+// channel colors, sampled from at most about 64K pixels, so building one
+// takes a few milliseconds regardless of image size. Map() finds the nearest
+// palette entry through a 32K entry table indexed by the same 5-bit colors,
+// which is filled in as colors are first seen.
+class AdaptivePalette {
+ public:
+  // Chooses up to 'colors' colors, which must be at most 256, for 'graphic'
+  // after opacifying it against 'bg', unless it's already opaque.
+  AdaptivePalette(const Graphic& graphic, const Pixel& bg, int colors);
+  AdaptivePalette(const AdaptivePalette& other) = delete;
+  void operator=(const AdaptivePalette& other) = delete;
+
+  // Returns the index of the palette color nearest to 'pix'. Thread safe.
+  uint8_t Map(const Pixel& pix) const;
+
+  inline const std::vector<Pixel>& colors() const { return colors_; }
+
+ private:
+  std::vector<Pixel> colors_;
+  Palette palette_;
+  std::unique_ptr<std::atomic<uint16_t>[]> lookup_;
+};
+
+#endif  // HIPTEXT_MEDIANCUT_H_
+
+// For Emacs:
+// Local Variables:
+// mode:c++
+// indent-tabs-mode:nil
+// tab-width:2
+// c-basic-offset:2
+// c-file-style: nil
+// End:
+// For VIM:
+// vim:set expandtab softtabstop=2 shiftwidth=2 tabstop=2:
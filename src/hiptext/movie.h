@@ -24,10 +24,12 @@ class Movie {
 
   void PrepareRGB(int width, int height);
   Graphic Next();
+  void Rewind();  // Seek back to the first frame.
 
   inline int width() const { return width_; }
   inline int height() const { return height_; }
   inline bool done() const { return done_; }
+  inline double delay() const { return delay_; }  // Of last Next() frame.
 
   // Make C++11 range-based loops work.
   struct iterator {
@@ -43,6 +45,7 @@ class Movie {
 
  private:
   bool done_ = false;  // True when media is complete.
+  double delay_ = 0.0;  // Seconds to display last frame, or 0 if unknown.
   int video_stream_;
   uint8_t* buffer_;
   AVCodec* codec_;
@@ -0,0 +1,91 @@
+// hiptext - Image to Text Converter
+// By Justine Tunney
+
+#ifndef HIPTEXT_PALETTE_H_
+#define HIPTEXT_PALETTE_H_
+
+#include <istream>
+#include <ostream>
+#include <vector>
+
+class Pixel;
+
+// Where distances between colors are measured.
+enum class ColorSpace {
+  kRGB,    // Euclidean distance between gamma encoded sRGB values.
+  kOKLab,  // Perceptually uniform, see http://bottosson.github.io/posts/oklab/
+};
+
+// Converts an opaque sRGB color to OKLab. Channels are quantized to 8 bits so
+// linearization can be done with a lookup table.
+void RGBToOKLab(const Pixel& pix, double lab[3]);
+
+// A fixed set of colors that can be searched for the nearest match.
+//
+// The colors are indexed with a k-d tree, so a query usually visits a handful
+// of nodes rather than the whole palette. Results are exact and identical to a
+// linear scan using Euclidean distance in the chosen color space, including
+// ties, which go to the lowest index. The palette is converted to that space
+// once up front, so perceptual matching only costs one conversion per query.
+class Palette {
+ public:
+  Palette() = default;
+  Palette(const Pixel* begin, const Pixel* end,
+          ColorSpace space = ColorSpace::kRGB);
+  explicit Palette(const std::vector<Pixel>& colors,
+                   ColorSpace space = ColorSpace::kRGB);
+
+  // Returns the index of the color closest to 'pix'. If 'distance' isn't null,
+  // it's set to the distance to that color, which for kRGB is the same thing
+  // Pixel::Distance() measures.
+  int Nearest(const Pixel& pix, double* distance = nullptr) const;
+
+  // Returns the distance between 'pix' and the color at 'index'.
+  double Distance(const Pixel& pix, int index) const;
+
+  inline int size() const { return static_cast<int>(points_.size()); }
+
+  // Writes the palette and its search tree in a machine specific format, so
+  // Load() can restore it without building the tree again.
+  void Save(std::ostream& out) const;
+
+  // Reads what Save() wrote. Returns false if the data is truncated or bad,
+  // in which case the palette is left unchanged.
+  bool Load(std::istream& in);
+
+ private:
+  struct Point {
+    double v[3];  // Coordinates in space_.
+    int index;
+  };
+
+  struct Node {
+    Point point;
+    int axis;   // Component this node splits on.
+    int left;   // Child node with smaller values, or -1.
+    int right;  // Child node with larger or equal values, or -1.
+  };
+
+  void Convert(const Pixel& pix, double v[3]) const;
+  int Build(std::vector<Point>* points, int begin, int end);
+  void Search(int node, const double v[3],
+              int* best, double* best_dist) const;
+
+  ColorSpace space_ = ColorSpace::kRGB;
+  std::vector<Point> points_;  // In index order.
+  std::vector<Node> nodes_;
+  int root_ = -1;
+};
+
+#endif  // HIPTEXT_PALETTE_H_
+
+// For Emacs:
+// Local Variables:
+// mode:c++
+// indent-tabs-mode:nil
+// tab-width:2
+// c-basic-offset:2
+// c-file-style: nil
+// End:
+// For VIM:
+// vim:set expandtab softtabstop=2 shiftwidth=2 tabstop=2:
@@ -0,0 +1,29 @@
+// hiptext - Image to Text Converter
+// By Justine Tunney
+
+#ifndef HIPTEXT_PARALLEL_H_
+#define HIPTEXT_PARALLEL_H_
+
+#include <functional>
+
+// Returns how many threads ParallelFor() will use, per --threads.
+int GetThreadCount();
+
+// Calls 'func' once for every index in [begin, end) using a shared pool of
+// worker threads, and returns once all calls have finished. Indices are handed
+// out in increasing order to whichever thread is free. Calls made from inside
+// 'func' run serially on the calling thread.
+void ParallelFor(int begin, int end, const std::function<void(int)>& func);
+
+#endif  // HIPTEXT_PARALLEL_H_
+
+// For Emacs:
+// Local Variables:
+// mode:c++
+// indent-tabs-mode:nil
+// tab-width:2
+// c-basic-offset:2
+// c-file-style: nil
+// End:
+// For VIM:
+// vim:set expandtab softtabstop=2 shiftwidth=2 tabstop=2:
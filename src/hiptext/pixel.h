@@ -4,6 +4,8 @@
 #ifndef HIPTEXT_PIXEL_H_
 #define HIPTEXT_PIXEL_H_
 
+#include <algorithm>
+#include <cstdint>
 #include <string>
 #include <ostream>
 
@@ -49,6 +51,8 @@ class Pixel {
   Pixel& FromHSL();
   Pixel& ToYUV();
   Pixel& FromYUV();
+  Pixel& ToLinear();    // sRGB to linear light, rounded to 8-bit codes.
+  Pixel& FromLinear();
   Pixel& Clamp();
 
   double Distance(const Pixel& other) const;
@@ -86,6 +90,12 @@ class Pixel {
 
 std::ostream& operator<<(std::ostream& os, const Pixel& pixel);
 
+// Converts a channel from zero to one into an 8-bit code, clamped and rounded.
+inline uint8_t ToByte(double value) {
+  return static_cast<uint8_t>(std::max(0.0, std::min(1.0, value)) * 255.0 +
+                              0.5);
+}
+
 #endif  // HIPTEXT_PIXEL_H_
 
 // For Emacs:
@@ -0,0 +1,55 @@
+// hiptext - Image to Text Converter
+// By Justine Tunney
+
+#ifndef HIPTEXT_RENDERCACHE_H_
+#define HIPTEXT_RENDERCACHE_H_
+
+#include <cstdint>
+#include <string>
+
+// An on-disk cache of final rendered terminal output.
+//
+// Entries are keyed on the identity of the input file (path, inode, size and
+// modification time) plus a salt describing everything else that influences
+// the output, e.g. terminal dimensions and command line flags. A hit costs a
+// single mmap() and write(). The directory is kept under a size budget by
+// evicting the least recently used entries, where each hit bumps the mtime.
+// Half written entries count toward the budget, and ones abandoned for a few
+// minutes are removed.
+class RenderCache {
+ public:
+  RenderCache(const std::string& dir, int64_t max_bytes);
+  RenderCache(const RenderCache& other) = delete;
+  void operator=(const RenderCache& other) = delete;
+
+  // Returns the key for 'path', or an empty string if it can't be stat'd.
+  std::string Key(const std::string& path, const std::string& salt) const;
+
+  // Writes the entry for 'key' to 'fd'. Returns false on a cache miss, or if
+  // none of it could be written. Output that's cut short partway is logged
+  // but still returns true, since the caller can't take it back.
+  bool Replay(const std::string& key, int fd) const;
+
+  // Saves 'data' under 'key' and then evicts entries until under budget.
+  void Store(const std::string& key, const std::string& data) const;
+
+ private:
+  std::string PathOf(const std::string& key) const;
+  void Evict() const;
+
+  std::string dir_;
+  int64_t max_bytes_;
+};
+
+#endif  // HIPTEXT_RENDERCACHE_H_
+
+// For Emacs:
+// Local Variables:
+// mode:c++
+// indent-tabs-mode:nil
+// tab-width:2
+// c-basic-offset:2
+// c-file-style: nil
+// End:
+// For VIM:
+// vim:set expandtab softtabstop=2 shiftwidth=2 tabstop=2:
@@ -0,0 +1,68 @@
+// hiptext - Image to Text Converter
+// By Justine Tunney
+
+#ifndef HIPTEXT_REPLAYCACHE_H_
+#define HIPTEXT_REPLAYCACHE_H_
+
+#include <chrono>
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Remembers the exact bytes written for each frame of an animation, and how
+// long each frame should stay on screen, so that subsequent loops can be
+// replayed with nothing more than write() calls. If the recording grows beyond the
+// budget it's thrown away and ok() returns false.
+class ReplayCache {
+ public:
+  explicit ReplayCache(size_t budget) : budget_(budget) {}
+  ReplayCache(const ReplayCache& other) = delete;
+  void operator=(const ReplayCache& other) = delete;
+
+  // Call after writing 'bytes' to the terminal, with the number of seconds
+  // the frame is meant to be shown for.
+  void Record(std::string bytes, double delay);
+
+  // Call once the first pass is over. 'first' is what it takes to draw the
+  // first frame over the last one, which renderers that only send changes
+  // can't do with the bytes they first wrote, so it stands in for them on
+  // every loop.
+  void Finish(std::string first);
+
+  // Writes each frame to 'out' and waits out its delay. Returns soon after
+  // '*stop' becomes true, even partway through a frame's delay.
+  void Play(std::ostream& out, const volatile bool* stop) const;
+
+  inline bool recording() const { return !overflowed_; }
+  inline bool ok() const { return !overflowed_ && !frames_.empty(); }
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Frame {
+    std::string bytes;
+    Clock::duration delay;
+  };
+
+  // Counts 'size' more bytes, or throws the recording away if they don't fit.
+  bool Reserve(size_t size);
+
+  size_t budget_;
+  size_t bytes_ = 0;
+  bool overflowed_ = false;
+  std::vector<Frame> frames_;
+};
+
+#endif  // HIPTEXT_REPLAYCACHE_H_
+
+// For Emacs:
+// Local Variables:
+// mode:c++
+// indent-tabs-mode:nil
+// tab-width:2
+// c-basic-offset:2
+// c-file-style: nil
+// End:
+// For VIM:
+// vim:set expandtab softtabstop=2 shiftwidth=2 tabstop=2:
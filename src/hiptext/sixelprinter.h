@@ -4,13 +4,27 @@
 #ifndef HIPTEXT_SIXELPRINTER_H_
 #define HIPTEXT_SIXELPRINTER_H_
 
+#include <bitset>
+#include <cstdint>
 #include <ostream>
+#include <string>
+
+class Pixel;
 
 // A wrapper around cout that generates DECSIXEL escape codes.
+//
+// Images are sent in bands of six rows, which is how SIXEL works. Within a
+// band, each color that's present is selected once and its pixels for all
+// six rows are sent as one run length encoded pass. Colors that don't appear
+// in the band cost nothing. Bands are encoded in parallel.
 class SixelPrinter {
  public:
+  // 'palette' holds the color of each register, or is null to use g_xterm.
+  // With two colors the image is monochrome: zero is off and anything else is
+  // drawn in the terminal's foreground color.
   explicit SixelPrinter(std::ostream& out, int colors,
-                        bool is8bit, bool bgprint, int bg);
+                        bool is8bit, bool bgprint, int bg,
+                        const Pixel* palette = nullptr);
 
   template<typename T>
   inline SixelPrinter& operator<<(const T& val) {
@@ -18,23 +32,36 @@ class SixelPrinter {
     return *this;
   }
 
-  void PrintPixel(int n);
-  void Start();
+  // Begins an image at the cursor. If 'overlay' is set, pixels that aren't
+  // drawn keep whatever was on the screen before.
+  void Start(bool overlay = false);
   void End();
-  void LineFeed();
+
+  // Prints 'height' rows of register numbers, each 'width' long, where each
+  // row starts 'stride' codes after the last. A zero stride means 'width'.
+  // Registers used by the image that aren't defined yet are defined first.
+  void PrintBands(const uint8_t* codes, int width, int height,
+                  int stride = 0);
+
+  // Registers that have been sent to the terminal. Setting this lets an
+  // image reuse the colors defined by an earlier one.
+  inline const std::bitset<256>& defined() const { return defined_; }
+  inline void set_defined(const std::bitset<256>& defined) {
+    defined_ = defined;
+  }
 
  private:
   void DefineColor(int n);
+  void EncodeBand(const uint8_t* codes, int width, int rows, int stride,
+                  std::string* out, std::bitset<256>* used) const;
 
   std::ostream& out_;
+  const Pixel* palette_;
   int colors_;
   bool is8bit_;   // whether the terminal accepts 8bit control (C1)
   bool bgprint_;
   int bg_;
-  int cache_;
-  int count_;
-  int sixel_offset_;
-  char slots_[256];
+  std::bitset<256> defined_;
 };
 
 #endif  // HIPTEXT_SIXELPRINTER_H_
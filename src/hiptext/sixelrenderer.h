@@ -0,0 +1,47 @@
+// hiptext - Image to Text Converter
+// By Justine Tunney
+
+#ifndef HIPTEXT_SIXELRENDERER_H_
+#define HIPTEXT_SIXELRENDERER_H_
+
+#include <memory>
+#include <ostream>
+
+class Graphic;
+
+// A RenderAlgorithm that draws images with SIXEL graphics.
+//
+// 256 color SIXEL is supported by RLogin, mlterm(X11/fb), and tanasinn. xterm
+// with the option "-ti vt340" is limited up to 16 colors. Two colors means
+// monochrome, where pixels are either on or off.
+//
+// Still images are drawn in full. While video is playing, the renderer
+// remembers the last frame so later ones only resend the cells that changed,
+// each positioned with a cursor move. The color registers are kept between
+// frames too, and only redefined once the picture has changed so much that
+// the old palette no longer fits.
+class SixelRenderer {
+ public:
+  explicit SixelRenderer(int colors);
+
+  void operator()(std::ostream& os, const Graphic& graphic);
+
+ private:
+  struct State;
+
+  int colors_;
+  std::shared_ptr<State> state_;  // Shared by copies of this functor.
+};
+
+#endif  // HIPTEXT_SIXELRENDERER_H_
+
+// For Emacs:
+// Local Variables:
+// mode:c++
+// indent-tabs-mode:nil
+// tab-width:2
+// c-basic-offset:2
+// c-file-style: nil
+// End:
+// For VIM:
+// vim:set expandtab softtabstop=2 shiftwidth=2 tabstop=2:
@@ -0,0 +1,31 @@
+// hiptext - Image to Text Converter
+// By Justine Tunney
+
+#ifndef HIPTEXT_SRGB_H_
+#define HIPTEXT_SRGB_H_
+
+#include <cstdint>
+
+// Images spend more of their codes on dark shades than light ones, the way
+// eyes do, but light only adds up right when it's linear. These convert
+// between the two with lookup tables rather than pow().
+
+// Linear light, from zero to one, of an 8-bit sRGB code.
+float SrgbToLinear(uint8_t code);
+
+// The sRGB code nearest 'linear', which is looked up in steps of 1/4095.
+// That's fine enough to turn every SrgbToLinear() result back into its code.
+uint8_t LinearToSrgb(double linear);
+
+#endif  // HIPTEXT_SRGB_H_
+
+// For Emacs:
+// Local Variables:
+// mode:c++
+// indent-tabs-mode:nil
+// tab-width:2
+// c-basic-offset:2
+// c-file-style: nil
+// End:
+// For VIM:
+// vim:set expandtab softtabstop=2 shiftwidth=2 tabstop=2:
@@ -0,0 +1,42 @@
+// hiptext - Image to Text Converter
+// By Justine Tunney
+
+#ifndef HIPTEXT_SUBCELL_H_
+#define HIPTEXT_SUBCELL_H_
+
+#include <ostream>
+
+class Graphic;
+class Pixel;
+
+// Renderers that split each character cell into a grid of pixels, where each
+// pixel is drawn in either the foreground or background color. The two
+// colors come from FitCell() and the character from the pattern it finds.
+// They use xterm256 colors, or 24-bit color with --truecolor.
+void PrintImageQuadrants(std::ostream& os, const Graphic& graphic);  // 2x2
+void PrintImageSextants(std::ostream& os, const Graphic& graphic);   // 2x3
+void PrintImageBraille(std::ostream& os, const Graphic& graphic);    // 2x4
+
+// Splits 'count' pixels into two clusters and returns a mask where bit n is
+// set if pixels[n] belongs to the first. The average colors of the clusters
+// are stored to 'fg' and 'bg'. The mask is zero if the pixels are all alike.
+int FitCell(const Pixel* pixels, int count, Pixel* fg, Pixel* bg);
+
+// Returns the character for a pattern of pixels, where bit y*2+x is set if
+// the pixel at column x and row y is drawn in the foreground color.
+wchar_t QuadrantGlyph(int mask);
+wchar_t SextantGlyph(int mask);
+wchar_t BrailleGlyph(int mask);
+
+#endif  // HIPTEXT_SUBCELL_H_
+
+// For Emacs:
+// Local Variables:
+// mode:c++
+// indent-tabs-mode:nil
+// tab-width:2
+// c-basic-offset:2
+// c-file-style: nil
+// End:
+// For VIM:
+// vim:set expandtab softtabstop=2 shiftwidth=2 tabstop=2:
@@ -0,0 +1,73 @@
+// hiptext - Image to Text Converter
+// By Justine Tunney
+
+#ifndef HIPTEXT_SUMMEDAREA_H_
+#define HIPTEXT_SUMMEDAREA_H_
+
+#include <cstdint>
+#include <vector>
+
+class Graphic;
+class Pixel;
+
+// Integral image of a Graphic, which gives the mean color of any rectangle,
+// and optionally its variance, with four lookups.
+//
+// Each entry is the sum of every pixel above and to the left of it, per
+// channel, in 16-bit fixed point. Sums are kept as uint64_t, so they stay
+// exact, squares included, up to four billion pixels.
+class SummedAreaTable {
+ public:
+  // 'squares' also sums squared channels, which Variance() needs.
+  explicit SummedAreaTable(const Graphic& graphic, bool squares = false);
+
+  inline int width() const { return width_; }
+  inline int height() const { return height_; }
+
+  // Copied from the Graphic, for AreaScale() to pass along.
+  inline bool opaque() const { return opaque_; }
+  inline bool premultiplied() const { return premultiplied_; }
+
+  // Mean of the 'w' by 'h' rectangle at ('x', 'y'), alpha included. The
+  // rectangle must be inside the image and not empty.
+  Pixel Mean(int x, int y, int w, int h) const;
+
+  // Variance of red, green and blue over the rectangle, added together.
+  double Variance(int x, int y, int w, int h) const;
+
+ private:
+  // Sums the rectangle into 'out', one entry per channel.
+  void Sum(const std::vector<uint64_t>& table, int x, int y, int w, int h,
+           uint64_t out[4]) const;
+
+  int width_;
+  int height_;
+  bool opaque_;
+  bool premultiplied_;
+  std::vector<uint64_t> sums_;     // (width + 1) by (height + 1) by RGBA.
+  std::vector<uint64_t> squares_;  // Same, if asked for, otherwise empty.
+};
+
+// Shrinks 'graphic' by averaging all the pixels that land in each output
+// pixel, so fine detail turns into the right shade rather than aliasing.
+// Enlarging makes each pixel a block, so use BilinearScale for that. Works
+// through the source one band of rows at a time, so unlike a table it only
+// needs memory for a row of sums.
+Graphic AreaScale(const Graphic& graphic, int new_width, int new_height);
+
+// Same, from a table, which pays off when it's reused for several sizes.
+Graphic AreaScale(const SummedAreaTable& table, int new_width,
+                  int new_height);
+
+#endif  // HIPTEXT_SUMMEDAREA_H_
+
+// For Emacs:
+// Local Variables:
+// mode:c++
+// indent-tabs-mode:nil
+// tab-width:2
+// c-basic-offset:2
+// c-file-style: nil
+// End:
+// For VIM:
+// vim:set expandtab softtabstop=2 shiftwidth=2 tabstop=2:
@@ -0,0 +1,36 @@
+// hiptext - Image to Text Converter
+// By Justine Tunney
+
+#ifndef HIPTEXT_TERMPALETTE_H_
+#define HIPTEXT_TERMPALETTE_H_
+
+#include <string>
+
+class Pixel;
+
+// Asks the terminal on /dev/tty for its 256 colors using OSC 4 and stores the
+// ones it reports in 'colors'. Gives up after 'timeout_ms' milliseconds.
+// Returns how many colors were reported.
+int QueryTerminalPalette(Pixel colors[256], int timeout_ms);
+
+// Parses OSC 4 replies like "\e]4;1;rgb:cdcd/0000/0000\a" out of 'reply'.
+// Returns how many colors were found.
+int ParsePaletteReply(const std::string& reply, Pixel colors[256]);
+
+// Makes the xterm color functions match against the terminal's real palette,
+// per --termpalette. The colors and lookup tables are cached per $TERM under
+// ~/.cache/hiptext, so only the first run has to ask the terminal.
+void LoadTerminalPalette();
+
+#endif  // HIPTEXT_TERMPALETTE_H_
+
+// For Emacs:
+// Local Variables:
+// mode:c++
+// indent-tabs-mode:nil
+// tab-width:2
+// c-basic-offset:2
+// c-file-style: nil
+// End:
+// For VIM:
+// vim:set expandtab softtabstop=2 shiftwidth=2 tabstop=2:
@@ -25,6 +25,8 @@ class TermPrinter {
   void SetFlip(bool flip);
   void SetForeground256(int code);
   void SetBackground256(int code);
+  void SetForegroundRGB(int red, int green, int blue);  // 24-bit color.
+  void SetBackgroundRGB(int red, int green, int blue);
 
   template<typename T>
   inline TermPrinter& operator<<(const T& val) {
@@ -53,6 +55,9 @@ class TermPrinter {
   static const int kBackgroundOff;
   static const int kForeground256;
   static const int kBackground256;
+  static const int kForegroundRGB;
+  static const int kBackgroundRGB;
+  static const int kTrueColor;
   static const char* kEscapeStart;
   static const char* kEscapeEnd;
   static const char* kEscapeSep;
@@ -73,6 +78,7 @@ class TermPrinter {
   bool IsStyled() const;
   void PrintSep(bool* first) const;
   void PrintCode(int code, bool* first);
+  void PrintColor(int selector, int color, bool* first);
 
   bool dirty_;
   State cur_;
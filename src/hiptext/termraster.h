@@ -0,0 +1,70 @@
+// hiptext - Image to Text Converter
+// By Justine Tunney
+
+#ifndef HIPTEXT_TERMRASTER_H_
+#define HIPTEXT_TERMRASTER_H_
+
+#include <string>
+#include <vector>
+
+class Graphic;
+
+// Colors of a TermCell are an xterm256 code, this flag ORed with 0xRRGGBB, or
+// kDefaultColor for whatever the terminal would use.
+const int kDefaultColor = -1;
+const int kRGBColor = 1 << 24;
+
+struct TermCell {
+  wchar_t glyph = L' ';
+  int fg = kDefaultColor;
+  int bg = kDefaultColor;
+};
+
+// The screen that some terminal output draws.
+//
+// This understands what hiptext's text modes print: UTF-8 text, newlines,
+// carriage returns, cursor positioning and SGR colors, including 256 color
+// and 24-bit ones. Other escape sequences and control strings are skipped.
+class TermGrid {
+ public:
+  TermGrid() = default;
+
+  void Write(const std::string& text);
+
+  // The size of the area that has been drawn on.
+  int width() const;
+  inline int height() const { return rows_.size(); }
+
+  // Returns a blank cell for places that were never drawn.
+  const TermCell& Get(int x, int y) const;
+
+ private:
+  void Put(wchar_t glyph);
+  void SelectGraphicRendition(const std::vector<int>& params);
+
+  std::vector<std::vector<TermCell>> rows_;
+  int x_ = 0;
+  int y_ = 0;
+  int fg_ = kDefaultColor;
+  int bg_ = kDefaultColor;
+  bool flip_ = false;
+};
+
+// Draws 'grid' as a terminal would, with glyphs from the GlyphAtlas. Cells
+// are the size of the font's 'M'. Block elements, including quadrants and
+// sextants, are drawn as exact shapes rather than with the font. Default
+// colors are --bg and xterm color 7.
+Graphic RasterizeTerminal(const TermGrid& grid);
+
+#endif  // HIPTEXT_TERMRASTER_H_
+
+// For Emacs:
+// Local Variables:
+// mode:c++
+// indent-tabs-mode:nil
+// tab-width:2
+// c-basic-offset:2
+// c-file-style: nil
+// End:
+// For VIM:
+// vim:set expandtab softtabstop=2 shiftwidth=2 tabstop=2:
@@ -5,15 +5,26 @@
 #define HIPTEXT_XTERM256_H_
 
 #include <cstdint>
+#include <istream>
+#include <ostream>
 
 class Pixel;
 
-extern const Pixel g_xterm[256];
+extern Pixel g_xterm[256];  // Only change with SetXtermColors().
 extern const uint8_t g_xterm_reverse[6][6][6];
 uint8_t rgb_to_xterm(const Pixel& pix, int begin, int end);
 uint8_t rgb_to_xterm16(const Pixel& pix);
 uint8_t rgb_to_xterm256(const Pixel& pix);
 
+// Replaces g_xterm, e.g. with the colors the terminal really uses, and
+// rebuilds the tables behind rgb_to_xterm16() and rgb_to_xterm256().
+void SetXtermColors(const Pixel colors[256]);
+
+// Saves g_xterm along with its lookup tables, so LoadXtermColors() can skip
+// rebuilding them. Returns false if the data is unusable.
+void SaveXtermColors(std::ostream& out);
+bool LoadXtermColors(std::istream& in);
+
 #endif  // HIPTEXT_XTERM256_H_
 
 // For Emacs:
@@ -3,7 +3,11 @@
 
 #include "hiptext/jpeg.h"
 
+#include <algorithm>
 #include <csetjmp>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
 #include <memory>
 #include <vector>
 
@@ -12,6 +16,10 @@
 
 #include "hiptext/pixel.h"
 #include "hiptext/graphic.h"
+#include "hiptext/parallel.h"
+
+// Below this size it isn't worth spinning up threads.
+static const int64_t kParallelMinPixels = 1 << 20;
 
 static void OnError(j_common_ptr cinfo) {
   char buffer[JMSG_LENGTH_MAX];
@@ -19,31 +27,316 @@ static void OnError(j_common_ptr cinfo) {
   LOG(FATAL) << "bad jpeg: " << buffer;
 }
 
-Graphic LoadJPEG(const std::string& path) {
+// Reads 'count' scanlines into 'out' after skipping 'skip' of them.
+static void ReadPixels(jpeg_decompress_struct* cinfo, int skip, int count,
+                       Pixel* out) {
+  int stride = cinfo->output_width * cinfo->output_components;
+  std::unique_ptr<uint8_t[]> line(new uint8_t[stride]);
+  uint8_t* buffer[1] = { line.get() };
+  for (int y = 0; y < skip + count; ++y) {
+    jpeg_read_scanlines(cinfo, buffer, 1);
+    if (y < skip) {
+      continue;
+    }
+    if (cinfo->out_color_space != JCS_CMYK) {
+      for (int n = 0; n < stride; n += cinfo->output_components) {
+        *out++ = Pixel(line[n], line[n + 1], line[n + 2]);
+      }
+      continue;
+    }
+    // libjpeg leaves CMYK alone. Adobe's files store it inverted, so 255
+    // means no ink, which is the way round that's needed here.
+    for (int n = 0; n < stride; n += 4) {
+      int light[4];
+      for (int c = 0; c < 4; ++c) {
+        light[c] = cinfo->saw_Adobe_marker ? line[n + c] : 255 - line[n + c];
+      }
+      *out++ = Pixel((light[0] * light[3] + 127) / 255,
+                     (light[1] * light[3] + 127) / 255,
+                     (light[2] * light[3] + 127) / 255);
+    }
+  }
+}
+
+// Reads the remaining scanlines of the current output pass.
+static std::vector<Pixel> ReadPixels(jpeg_decompress_struct* cinfo) {
+  std::vector<Pixel> pixels(cinfo->output_width * cinfo->output_height);
+  ReadPixels(cinfo, 0, cinfo->output_height - cinfo->output_scanline,
+             pixels.data());
+  return pixels;
+}
+
+static void Prepare(jpeg_decompress_struct* cinfo, jpeg_error_mgr* jerr) {
+  cinfo->err = jpeg_std_error(jerr);
+  jerr->error_exit = OnError;
+  jpeg_create_decompress(cinfo);
+}
+
+static void ReadHeader(jpeg_decompress_struct* cinfo) {
+  CHECK(jpeg_read_header(cinfo, TRUE) == JPEG_HEADER_OK);
+  // libjpeg can't turn CMYK or YCCK into RGB, only YCCK into CMYK, so
+  // ReadPixels() does the rest.
+  if (cinfo->jpeg_color_space == JCS_CMYK ||
+      cinfo->jpeg_color_space == JCS_YCCK) {
+    cinfo->out_color_space = JCS_CMYK;
+  } else {
+    cinfo->out_color_space = JCS_RGB;
+  }
+}
+
+static FILE* Open(const std::string& path, jpeg_decompress_struct* cinfo,
+                  jpeg_error_mgr* jerr) {
   FILE* fp = fopen(path.data(), "rb");
   PCHECK(fp) << path;
+  Prepare(cinfo, jerr);
+  jpeg_stdio_src(cinfo, fp);
+  ReadHeader(cinfo);
+  return fp;
+}
+
+static inline int ReadShort(const uint8_t* p) {
+  return (p[0] << 8) | p[1];
+}
+
+// Where things are inside a baseline JPEG with restart markers.
+struct Layout {
+  size_t height_offset;  // Of the SOF frame height field.
+  size_t scan_offset;    // Where the entropy coded data begins.
+  int width;
+  int height;
+  int mcu_height;
+  int mcus_per_row;
+  int restart_interval;                 // In MCUs.
+  std::vector<size_t> interval_begin;  // Entropy data for each interval.
+  std::vector<size_t> interval_end;
+};
+
+// Finds the restart intervals of a single scan baseline JPEG. Returns false
+// for anything else, e.g. progressive files or files without restart markers.
+static bool ParseLayout(const uint8_t* data, size_t size, Layout* layout) {
+  if (size < 4 || data[0] != 0xff || data[1] != 0xd8) {
+    return false;
+  }
+  int components = 0;
+  int max_h = 1;
+  int max_v = 1;
+  layout->height_offset = 0;
+  layout->restart_interval = 0;
+  size_t pos = 2;
+  for (;;) {
+    while (pos < size && data[pos] == 0xff) {
+      ++pos;
+    }
+    if (pos + 3 > size || data[pos - 1] != 0xff) {
+      return false;
+    }
+    int marker = data[pos++];
+    size_t length = ReadShort(data + pos);
+    if (length < 2 || pos + length > size) {
+      return false;
+    }
+    const uint8_t* segment = data + pos + 2;
+    if (marker == 0xc0 || marker == 0xc1) {  // Baseline or extended DCT.
+      if (length < 8) {
+        return false;
+      }
+      layout->height_offset = pos + 3;
+      layout->height = ReadShort(segment + 1);
+      layout->width = ReadShort(segment + 3);
+      components = segment[5];
+      if (length < 8u + components * 3) {
+        return false;
+      }
+      for (int n = 0; n < components; ++n) {
+        max_h = std::max(max_h, segment[6 + n * 3 + 1] >> 4);
+        max_v = std::max(max_v, segment[6 + n * 3 + 1] & 15);
+      }
+    } else if ((marker & 0xf0) == 0xc0 && marker != 0xc4 && marker != 0xc8 &&
+               marker != 0xcc) {
+      return false;  // Progressive, lossless, arithmetic, etc.
+    } else if (marker == 0xdd && length >= 4) {  // Define restart interval.
+      layout->restart_interval = ReadShort(segment);
+    } else if (marker == 0xda) {  // Start of scan.
+      if (!layout->height_offset || segment[0] != components) {
+        return false;  // Not a single interleaved scan.
+      }
+      layout->scan_offset = pos + length;
+      break;
+    }
+    pos += length;
+  }
+  if (layout->restart_interval == 0 || layout->height == 0) {
+    return false;
+  }
+  if (components == 1) {
+    max_h = max_v = 1;  // A non-interleaved MCU is always one block.
+  }
+  layout->mcu_height = max_v * 8;
+  int mcu_width = max_h * 8;
+  layout->mcus_per_row = (layout->width + mcu_width - 1) / mcu_width;
+
+  // Walk the entropy coded data looking for RSTn markers.
+  layout->interval_begin.assign(1, layout->scan_offset);
+  layout->interval_end.clear();
+  for (pos = layout->scan_offset; pos + 1 < size; ++pos) {
+    if (data[pos] != 0xff || data[pos + 1] == 0x00 || data[pos + 1] == 0xff) {
+      continue;
+    }
+    layout->interval_end.push_back(pos);
+    if (data[pos + 1] < 0xd0 || data[pos + 1] > 0xd7) {
+      break;  // Probably EOI.
+    }
+    layout->interval_begin.push_back(pos + 2);
+  }
+  int mcu_rows = (layout->height + layout->mcu_height - 1) / layout->mcu_height;
+  int mcus = layout->mcus_per_row * mcu_rows;
+  int intervals = (mcus + layout->restart_interval - 1) /
+      layout->restart_interval;
+  return (layout->interval_end.size() == layout->interval_begin.size() &&
+          static_cast<int>(layout->interval_begin.size()) == intervals);
+}
+
+// Builds a standalone JPEG holding restart intervals [first, last) which must
+// span whole MCU rows. Markers are renumbered so libjpeg doesn't resync.
+static std::string MakeStripe(const uint8_t* data, const Layout& layout,
+                              int first, int last, int rows) {
+  std::string res(reinterpret_cast<const char*>(data), layout.scan_offset);
+  res[layout.height_offset] = static_cast<char>(rows >> 8);
+  res[layout.height_offset + 1] = static_cast<char>(rows & 0xff);
+  for (int n = first; n < last; ++n) {
+    if (n > first) {
+      res += '\xff';
+      res += static_cast<char>(0xd0 + (n - first - 1) % 8);
+    }
+    res.append(reinterpret_cast<const char*>(data) + layout.interval_begin[n],
+               layout.interval_end[n] - layout.interval_begin[n]);
+  }
+  res += "\xff\xd9";
+  return res;
+}
+
+static void DecodeMemory(const std::string& jpeg, jpeg_decompress_struct* cinfo,
+                         jpeg_error_mgr* jerr) {
+  Prepare(cinfo, jerr);
+  jpeg_mem_src(cinfo,
+               reinterpret_cast<unsigned char*>(const_cast<char*>(jpeg.data())),
+               jpeg.size());
+  ReadHeader(cinfo);
+  CHECK(jpeg_start_decompress(cinfo) == TRUE);
+}
+
+// Decodes horizontal stripes of the image on separate threads. Restart
+// markers reset the DC predictors, so the entropy coded data for each stripe
+// can be decoded without looking at what came before it.
+static bool DecodeParallel(const std::string& data, Graphic* graphic) {
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data.data());
+  Layout layout;
+  if (!ParseLayout(bytes, data.size(), &layout) ||
+      static_cast<int64_t>(layout.width) * layout.height < kParallelMinPixels) {
+    return false;
+  }
+  // Stripes may only begin at intervals which begin a new row of MCUs.
+  std::vector<int> starts;
+  for (int n = 0; n < static_cast<int>(layout.interval_begin.size()); ++n) {
+    if (static_cast<int64_t>(n) * layout.restart_interval %
+        layout.mcus_per_row == 0) {
+      starts.push_back(n);
+    }
+  }
+  int stripes = std::min<int>(starts.size(), GetThreadCount() * 4);
+  if (stripes < 2) {
+    return false;
+  }
+  std::vector<int> bounds;  // Index into 'starts' where each stripe begins.
+  for (int n = 0; n < stripes; ++n) {
+    bounds.push_back(n * starts.size() / stripes);
+  }
+  bounds.push_back(starts.size());
+  starts.push_back(layout.interval_begin.size());
+  auto row_of = [&](int interval) {
+    int64_t mcu = static_cast<int64_t>(interval) * layout.restart_interval;
+    int64_t row = (mcu + layout.mcus_per_row - 1) / layout.mcus_per_row;
+    return static_cast<int>(std::min<int64_t>(row * layout.mcu_height,
+                                              layout.height));
+  };
+  LOG(INFO) << "Decoding JPEG in " << stripes << " stripes.";
+  std::vector<Pixel> pixels(layout.width * layout.height);
+  ParallelFor(0, stripes, [&](int stripe) {
+    // Chroma upsampling looks at neighboring rows, so each stripe is decoded
+    // with a little overlap on either side to get identical output.
+    int first = starts[std::max(bounds[stripe] - 1, 0)];
+    int last = starts[std::min<int>(bounds[stripe + 1] + 1, starts.size() - 1)];
+    int top = row_of(starts[bounds[stripe]]);
+    int bottom = row_of(starts[bounds[stripe + 1]]);
+    std::string jpeg = MakeStripe(bytes, layout, first, last,
+                                  row_of(last) - row_of(first));
+    jpeg_decompress_struct cinfo;
+    jpeg_error_mgr jerr;
+    DecodeMemory(jpeg, &cinfo, &jerr);
+    CHECK_EQ(layout.width, static_cast<int>(cinfo.output_width));
+    CHECK_EQ(row_of(last) - row_of(first),
+             static_cast<int>(cinfo.output_height));
+    ReadPixels(&cinfo, top - row_of(first), bottom - top,
+               pixels.data() + static_cast<size_t>(top) * layout.width);
+    jpeg_abort_decompress(&cinfo);
+    jpeg_destroy_decompress(&cinfo);
+  });
+  *graphic = Graphic(layout.width, layout.height, std::move(pixels));
+  graphic->set_opaque(true);
+  return true;
+}
+
+Graphic DecodeJPEG(const std::string& data) {
+  Graphic graphic(0, 0);
+  if (GetThreadCount() > 1 && DecodeParallel(data, &graphic)) {
+    return graphic;
+  }
   jpeg_decompress_struct cinfo;
   jpeg_error_mgr jerr;
-  cinfo.err = jpeg_std_error(&jerr);
-  jerr.error_exit = OnError;
-  jpeg_create_decompress(&cinfo);
-  jpeg_stdio_src(&cinfo, fp);
-  CHECK(jpeg_read_header(&cinfo, TRUE) == JPEG_HEADER_OK);
+  DecodeMemory(data, &cinfo, &jerr);
+  std::vector<Pixel> pixels = ReadPixels(&cinfo);
+  jpeg_finish_decompress(&cinfo);
+  jpeg_destroy_decompress(&cinfo);
+  Graphic res(cinfo.output_width, cinfo.output_height, std::move(pixels));
+  res.set_opaque(true);
+  return res;
+}
+
+Graphic LoadJPEG(const std::string& path) {
+  std::ifstream input(path, std::ios::binary);
+  PCHECK(input) << path;
+  std::string data((std::istreambuf_iterator<char>(input)),
+                   std::istreambuf_iterator<char>());
+  return DecodeJPEG(data);
+}
+
+void LoadJPEGProgressive(const std::string& path,
+                         const std::function<void(Graphic)>& callback) {
+  jpeg_decompress_struct cinfo;
+  jpeg_error_mgr jerr;
+  FILE* fp = Open(path, &cinfo, &jerr);
+  if (!jpeg_has_multiple_scans(&cinfo)) {
+    jpeg_destroy_decompress(&cinfo);
+    fclose(fp);
+    callback(LoadJPEG(path));
+    return;
+  }
+  // In buffered-image mode libjpeg keeps the DCT coefficients around so we
+  // can run an output pass each time another scan has arrived.
+  cinfo.buffered_image = TRUE;
   CHECK(jpeg_start_decompress(&cinfo) == TRUE);
-  int stride = cinfo.output_width * cinfo.output_components;
-  std::unique_ptr<uint8_t[]> line(new uint8_t[stride]);
-  uint8_t* buffer[1] = { line.get() };
-  std::vector<Pixel> pixels;
-  while (cinfo.output_scanline < cinfo.output_height) {
-    jpeg_read_scanlines(&cinfo, buffer, 1);
-    for (int n = 0; n < stride; n += cinfo.output_components) {
-      pixels.emplace_back(line[n], line[n + 1], line[n + 2]);
-    }
+  while (!jpeg_input_complete(&cinfo)) {
+    jpeg_start_output(&cinfo, cinfo.input_scan_number);
+    std::vector<Pixel> pixels = ReadPixels(&cinfo);
+    jpeg_finish_output(&cinfo);
+    Graphic graphic(cinfo.output_width, cinfo.output_height,
+                    std::move(pixels));
+    graphic.set_opaque(true);
+    callback(std::move(graphic));
   }
   jpeg_finish_decompress(&cinfo);
   jpeg_destroy_decompress(&cinfo);
   fclose(fp);
-  return Graphic(cinfo.output_width, cinfo.output_height, std::move(pixels));
 }
 
 // For Emacs:
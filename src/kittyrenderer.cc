@@ -0,0 +1,309 @@
+// hiptext - Image to Text Converter
+// By Justine Tunney
+
+#include "hiptext/kittyrenderer.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include "hiptext/artiste.h"
+#include "hiptext/graphic.h"
+#include "hiptext/parallel.h"
+#include "hiptext/pixel.h"
+
+DEFINE_string(kitty_transfer, "auto", "How --kitty hands pixels to the "
+              "terminal: shm (POSIX shared memory), file (a temporary file), "
+              "direct (inline base64, which works over ssh) or auto, which is "
+              "direct in ssh sessions and shm otherwise");
+
+namespace {
+
+enum class Transfer { kDirect, kFile, kShm };
+
+// The protocol limits each escape code to this much base64 payload.
+const size_t kChunkSize = 4096;
+
+// How many distinct video frames to keep in the terminal for reuse.
+const size_t kMaxImages = 16;
+
+Transfer GetTransfer() {
+  const std::string& mode = FLAGS_kitty_transfer;
+  if (mode == "direct") {
+    return Transfer::kDirect;
+  } else if (mode == "file") {
+    return Transfer::kFile;
+  } else if (mode == "shm") {
+    return Transfer::kShm;
+  } else if (mode != "auto") {
+    LOG(FATAL) << "Unknown --kitty_transfer: " << mode;
+  }
+  // The terminal can't see our files from the other end of an ssh session.
+  if (getenv("SSH_CONNECTION") || getenv("SSH_TTY")) {
+    return Transfer::kDirect;
+  }
+  return Transfer::kShm;
+}
+
+std::vector<uint8_t> ToRGBA(const Graphic& graphic) {
+  int width = graphic.width();
+  std::vector<uint8_t> rgba(static_cast<size_t>(width) * graphic.height() * 4);
+  ParallelFor(0, graphic.height(), [&](int y) {
+    uint8_t* out = &rgba[static_cast<size_t>(y) * width * 4];
+    for (int x = 0; x < width; ++x, out += 4) {
+      const Pixel& pix = graphic.Get(x, y);
+      out[0] = ToByte(pix.red());
+      out[1] = ToByte(pix.green());
+      out[2] = ToByte(pix.blue());
+      out[3] = ToByte(pix.alpha());
+    }
+  });
+  return rgba;
+}
+
+// FNV-1a a word at a time, which is plenty for telling frames apart.
+uint64_t Hash(const std::vector<uint8_t>& data) {
+  uint64_t hash = 0xcbf29ce484222325ull;
+  size_t n = 0;
+  for (; n + 8 <= data.size(); n += 8) {
+    uint64_t word;
+    memcpy(&word, &data[n], 8);
+    hash = (hash ^ word) * 0x100000001b3ull;
+  }
+  for (; n < data.size(); ++n) {
+    hash = (hash ^ data[n]) * 0x100000001b3ull;
+  }
+  return hash;
+}
+
+std::string Base64(const uint8_t* data, size_t size) {
+  static const char kAlphabet[] =
+      "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  std::string res;
+  res.reserve((size + 2) / 3 * 4);
+  size_t n = 0;
+  for (; n + 3 <= size; n += 3) {
+    uint32_t v = data[n] << 16 | data[n + 1] << 8 | data[n + 2];
+    res += kAlphabet[v >> 18];
+    res += kAlphabet[v >> 12 & 63];
+    res += kAlphabet[v >> 6 & 63];
+    res += kAlphabet[v & 63];
+  }
+  if (n < size) {
+    uint32_t v = data[n] << 16 | (n + 1 < size ? data[n + 1] << 8 : 0);
+    res += kAlphabet[v >> 18];
+    res += kAlphabet[v >> 12 & 63];
+    res += (n + 1 < size) ? kAlphabet[v >> 6 & 63] : '=';
+    res += '=';
+  }
+  return res;
+}
+
+inline std::string Base64(const std::string& str) {
+  return Base64(reinterpret_cast<const uint8_t*>(str.data()), str.size());
+}
+
+// Returns the name of a new shared memory object holding 'data', or an empty
+// string on failure. The terminal unlinks it once it's been read.
+std::string WriteSharedMemory(const std::vector<uint8_t>& data) {
+  static int counter = 0;
+  std::string name = "/hiptext-" + std::to_string(getpid()) + "-" +
+                     std::to_string(counter++);
+  int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+  if (fd < 0) {
+    PLOG(WARNING) << "shm_open " << name;
+    return "";
+  }
+  void* map = MAP_FAILED;
+  if (ftruncate(fd, data.size()) == 0) {
+    map = mmap(nullptr, data.size(), PROT_WRITE, MAP_SHARED, fd, 0);
+  }
+  close(fd);
+  if (map == MAP_FAILED) {
+    PLOG(WARNING) << "mmap " << name;
+    shm_unlink(name.c_str());
+    return "";
+  }
+  memcpy(map, data.data(), data.size());
+  munmap(map, data.size());
+  return name;
+}
+
+// Returns the path of a new temporary file holding 'data', or an empty string
+// on failure. The terminal deletes it once it's been read, which it's only
+// willing to do for names that say they're meant for this.
+std::string WriteTempFile(const std::vector<uint8_t>& data) {
+  const char* dir = getenv("TMPDIR");
+  std::string path = (dir && *dir) ? dir : "/tmp";
+  path += "/hiptext-tty-graphics-protocol-XXXXXX";
+  int fd = mkstemp(&path[0]);
+  if (fd < 0) {
+    PLOG(WARNING) << "mkstemp " << path;
+    return "";
+  }
+  const uint8_t* p = data.data();
+  size_t size = data.size();
+  while (size) {
+    ssize_t rc = write(fd, p, size);
+    if (rc < 0) {
+      if (errno == EINTR)
+        continue;
+      PLOG(WARNING) << "write " << path;
+      close(fd);
+      unlink(path.c_str());
+      return "";
+    }
+    p += rc;
+    size -= rc;
+  }
+  close(fd);
+  return path;
+}
+
+// Sends an image to the terminal and places it at the cursor. 'keys' holds
+// any further control data, each key preceded by a comma.
+void Transmit(std::ostream& os, const std::vector<uint8_t>& rgba, int width,
+              int height, const std::string& keys) {
+  std::string control = "a=T,f=32,s=" + std::to_string(width) +
+                        ",v=" + std::to_string(height) + ",q=2" + keys;
+  Transfer transfer = GetTransfer();
+  if (transfer == Transfer::kShm) {
+    std::string name = WriteSharedMemory(rgba);
+    if (!name.empty()) {
+      os << "\x1b_G" << control << ",t=s;" << Base64(name) << "\x1b\\";
+      return;
+    }
+    transfer = Transfer::kFile;
+  }
+  if (transfer == Transfer::kFile) {
+    std::string path = WriteTempFile(rgba);
+    if (!path.empty()) {
+      os << "\x1b_G" << control << ",t=t;" << Base64(path) << "\x1b\\";
+      return;
+    }
+  }
+  // Only the first chunk carries the control data. The rest just say whether
+  // there's more to come.
+  std::string data = Base64(rgba.data(), rgba.size());
+  for (size_t pos = 0; pos < data.size(); pos += kChunkSize) {
+    size_t size = std::min(kChunkSize, data.size() - pos);
+    os << "\x1b_G" << (pos ? "q=2" : control)
+       << ",m=" << (pos + size < data.size() ? 1 : 0) << ";";
+    os.write(data.data() + pos, size);
+    os << "\x1b\\";
+  }
+}
+
+struct SentImage {
+  uint64_t hash;
+  uint32_t id;
+};
+
+}  // namespace
+
+struct KittyRenderer::State {
+  std::vector<SentImage> images;  // Frames the terminal has, oldest first.
+  uint32_t shown = 0;             // ID of the image on the screen, if any.
+  uint32_t first = 0;             // ID of the first video frame, if any.
+  uint32_t next_id = 0;
+};
+
+KittyRenderer::KittyRenderer() : state_(std::make_shared<State>()) {
+  // Image IDs are global to the terminal, so pick ours at random to keep out
+  // of the way of other programs.
+  std::random_device random;
+  state_->next_id = random() % 0x7f000000 + 1;
+}
+
+void KittyRenderer::operator()(std::ostream& os, const Graphic& graphic) {
+  State& state = *state_;
+  int width = graphic.width();
+  int height = graphic.height();
+  if (!width || !height) {
+    return;
+  }
+  std::vector<uint8_t> rgba = ToRGBA(graphic);
+
+  if (!IsPlayingVideo()) {
+    state.images.clear();
+    state.shown = 0;
+    state.first = 0;
+    // Leave the cursor put and then move down past the image with newlines,
+    // like the text renderers, so RepaintImage() knows how to get back.
+    int cell_width;
+    int cell_height;
+    if (GetCellSize(&cell_width, &cell_height)) {
+      Transmit(os, rgba, width, height, ",C=1");
+      os << std::string((height + cell_height - 1) / cell_height, '\n');
+    } else {
+      Transmit(os, rgba, width, height, "");
+      os << "\n";
+    }
+    return;
+  }
+
+  uint64_t hash = Hash(rgba);
+  auto it = std::find_if(state.images.begin(), state.images.end(),
+                         [&](const SentImage& image) {
+                           return image.hash == hash;
+                         });
+  uint32_t id;
+  if (it != state.images.end()) {
+    id = it->id;
+    if (id == state.shown) {
+      return;
+    }
+    std::rotate(it, it + 1, state.images.end());
+    os << "\x1b_Ga=p,i=" << id << ",p=1,C=1,q=2\x1b\\";
+  } else {
+    id = state.next_id++;
+    Transmit(os, rgba, width, height,
+             ",i=" + std::to_string(id) + ",p=1,C=1");
+    state.images.push_back({hash, id});
+    if (!state.first) {
+      state.first = id;
+    }
+  }
+  // Take down the old frame only once the new one is up, so nothing flickers.
+  if (state.shown) {
+    os << "\x1b_Ga=d,d=i,i=" << state.shown << ",p=1,q=2\x1b\\";
+  }
+  state.shown = id;
+  // The first frame is kept for good, so that looping back to it never has to
+  // send it again under some other ID than the next frame takes down.
+  if (state.images.size() > kMaxImages) {
+    auto old = state.images.begin();
+    if (old->id == state.first) {
+      ++old;
+    }
+    os << "\x1b_Ga=d,d=I,i=" << old->id << ",q=2\x1b\\";
+    state.images.erase(old);
+  }
+}
+
+bool KittyOutputIsReplayable() {
+  return GetTransfer() == Transfer::kDirect;
+}
+
+// For Emacs:
+// Local Variables:
+// mode:c++
+// indent-tabs-mode:nil
+// tab-width:2
+// c-basic-offset:2
+// c-file-style: nil
+// End:
+// For VIM:
+// vim:set expandtab softtabstop=2 shiftwidth=2 tabstop=2:
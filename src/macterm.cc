@@ -9,56 +9,103 @@
 #include <iterator>
 #include <utility>
 
+#include <gflags/gflags.h>
 #include <glog/logging.h>
 
+#include "hiptext/artiste.h"
+#include "hiptext/palette.h"
 #include "hiptext/pixel.h"
 
+DECLARE_bool(oklab);
+
 using std::array;
 using std::distance;
 using std::min_element;
 
+namespace {
+
+const int kCacheBits = 14;
+
+struct CacheEntry {
+  uint64_t key;  // Zero means empty.
+  uint8_t fg;
+  uint8_t bg;
+  wchar_t symbol;
+};
+
+inline uint64_t Reduce(double value) {
+  value = std::max(0.0, std::min(1.0, value));
+  return static_cast<uint64_t>(value * 63.0 + 0.5);
+}
+
+// Packs a color into 18 bits.
+inline uint64_t Reduce(const Pixel& pix) {
+  return (Reduce(pix.red()) << 12 |
+          Reduce(pix.green()) << 6 |
+          Reduce(pix.blue()));
+}
+
+inline Pixel Expand(uint64_t bits) {
+  auto level = [](uint64_t v) { return static_cast<int>((v & 63) * 255 / 63); };
+  return Pixel(level(bits >> 12), level(bits >> 6), level(bits));
+}
+
+}  // namespace
+
+// Choosing a cell means searching both palettes for both pixels, which is too
+// slow to do for every cell of every video frame. But neighboring cells and
+// consecutive frames are mostly the same colors, so during video the choice
+// is memoized in a direct mapped table keyed on both colors at six bits per
+// channel. The answer is then computed from the reduced colors, so it doesn't
+// depend on what happens to be in the table. Stills get the exact answer.
 MactermColor::MactermColor(const Pixel& top, const Pixel& bot) {
+  if (!IsPlayingVideo()) {
+    Compute(top, bot);
+    return;
+  }
+  thread_local CacheEntry cache[1 << kCacheBits];
+  uint64_t colors = Reduce(top) << 18 | Reduce(bot);
+  uint64_t key = (colors << 1 | (FLAGS_oklab ? 1 : 0)) + 1;
+  CacheEntry& entry = cache[(key * 0x9e3779b97f4a7c15ull) >> (64 - kCacheBits)];
+  if (entry.key != key) {
+    Compute(Expand(colors >> 18), Expand(colors));
+    entry = {key, fg_, bg_, symbol_};
+  }
+  fg_ = entry.fg;
+  bg_ = entry.bg;
+  symbol_ = entry.symbol;
+}
+
+void MactermColor::Compute(const Pixel& top, const Pixel& bot) {
+  static const Palette rgb[2] = {
+    Palette(macterm_colors[0] + 16, macterm_colors[0] + 256),
+    Palette(macterm_colors[1] + 16, macterm_colors[1] + 256),
+  };
+  static const Palette oklab[2] = {
+    Palette(macterm_colors[0] + 16, macterm_colors[0] + 256,
+            ColorSpace::kOKLab),
+    Palette(macterm_colors[1] + 16, macterm_colors[1] + 256,
+            ColorSpace::kOKLab),
+  };
+  const Palette& fg_palette = FLAGS_oklab ? oklab[0] : rgb[0];
+  const Palette& bg_palette = FLAGS_oklab ? oklab[1] : rgb[1];
   struct Match {
     uint8_t code;
     double dist;
   };
-  Match best_fg_top = {0, 1e6};
-  Match best_fg_bot = {0, 1e6};
-  Match best_bg_top = {0, 1e6};
-  Match best_bg_bot = {0, 1e6};
-  double dist;
-  for (int code = 16; code < 256; ++code) {
-    dist = top.Distance(macterm_colors[0][code]);
-    if (dist < best_fg_top.dist) {
-      best_fg_top.code = code;
-      best_fg_top.dist = dist;
-    }
-    dist = bot.Distance(macterm_colors[0][code]);
-    if (dist < best_fg_bot.dist) {
-      best_fg_bot.code = code;
-      best_fg_bot.dist = dist;
-    }
-  }
-  for (int code = 16; code < 256; ++code) {
-    dist = top.Distance(macterm_colors[1][code]);
-    if (dist < best_bg_top.dist) {
-      best_bg_top.code = code;
-      best_bg_top.dist = dist;
-    }
-    dist = bot.Distance(macterm_colors[1][code]);
-    if (dist < best_bg_bot.dist) {
-      best_bg_bot.code = code;
-      best_bg_bot.dist = dist;
-    }
-  }
+  Match best_fg_top, best_fg_bot, best_bg_top, best_bg_bot;
+  best_fg_top.code = 16 + fg_palette.Nearest(top, &best_fg_top.dist);
+  best_fg_bot.code = 16 + fg_palette.Nearest(bot, &best_fg_bot.dist);
+  best_bg_top.code = 16 + bg_palette.Nearest(top, &best_bg_top.dist);
+  best_bg_bot.code = 16 + bg_palette.Nearest(bot, &best_bg_bot.dist);
 
   array<double, 6> choices = {{
       best_fg_top.dist + best_bg_bot.dist,
       best_bg_top.dist + best_fg_bot.dist,
-      best_fg_top.dist + bot.Distance(macterm_colors[0][best_fg_top.code]),
-      best_fg_bot.dist + top.Distance(macterm_colors[0][best_fg_bot.code]),
-      best_bg_top.dist + bot.Distance(macterm_colors[1][best_bg_top.code]),
-      best_bg_bot.dist + top.Distance(macterm_colors[1][best_bg_bot.code])}};
+      best_fg_top.dist + fg_palette.Distance(bot, best_fg_top.code - 16),
+      best_fg_bot.dist + fg_palette.Distance(top, best_fg_bot.code - 16),
+      best_bg_top.dist + bg_palette.Distance(bot, best_bg_top.code - 16),
+      best_bg_bot.dist + bg_palette.Distance(top, best_bg_bot.code - 16)}};
   switch (distance(choices.begin(),
                    min_element(choices.begin(), choices.end()))) {
     case 0:
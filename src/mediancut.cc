@@ -0,0 +1,175 @@
+// hiptext - Image to Text Converter
+// By Justine Tunney
+
+#include "hiptext/mediancut.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <glog/logging.h>
+
+#include "hiptext/graphic.h"
+
+namespace {
+
+const int kBins = 1 << 15;
+const uint16_t kUnknown = 0xffff;
+const int kMaxSamples = 1 << 16;
+
+inline int BinOf(const Pixel& pix) {
+  return ((ToByte(pix.red()) >> 3) << 10 |
+          (ToByte(pix.green()) >> 3) << 5 |
+          (ToByte(pix.blue()) >> 3));
+}
+
+// Returns a channel of a bin, as the middle of its 8-bit range.
+inline int Channel(int bin, int axis) {
+  return ((bin >> (10 - 5 * axis)) & 31) << 3 | 4;
+}
+
+struct Bin {
+  int color;
+  uint32_t count;
+  uint64_t sum[3];  // Of the actual 8-bit channels that landed here.
+};
+
+struct Box {
+  int begin;  // Range of bins.
+  int end;
+  uint64_t count;
+  int axis;   // Channel with the widest range.
+  int range;
+};
+
+Box MakeBox(const std::vector<Bin>& bins, int begin, int end) {
+  Box box = {begin, end, 0, 0, -1};
+  for (int axis = 0; axis < 3; ++axis) {
+    int lo = 255;
+    int hi = 0;
+    for (int n = begin; n < end; ++n) {
+      int v = Channel(bins[n].color, axis);
+      lo = std::min(lo, v);
+      hi = std::max(hi, v);
+    }
+    if (hi - lo > box.range) {
+      box.range = hi - lo;
+      box.axis = axis;
+    }
+  }
+  for (int n = begin; n < end; ++n) {
+    box.count += bins[n].count;
+  }
+  return box;
+}
+
+}  // namespace
+
+AdaptivePalette::AdaptivePalette(const Graphic& graphic, const Pixel& bg,
+                                 int colors)
+    : lookup_(new std::atomic<uint16_t>[kBins]) {
+  CHECK(1 <= colors && colors <= 256);
+  for (int n = 0; n < kBins; ++n) {
+    lookup_[n].store(kUnknown, std::memory_order_relaxed);
+  }
+
+  std::vector<Bin> histogram(kBins);
+  int area = graphic.width() * graphic.height();
+  int step = std::max(1, static_cast<int>(
+      std::ceil(std::sqrt(static_cast<double>(area) / kMaxSamples))));
+  // Renderers are handed images that Artiste already opacified.
+  bool opaque = graphic.opaque();
+  for (int y = step / 2; y < graphic.height(); y += step) {
+    for (int x = step / 2; x < graphic.width(); x += step) {
+      Pixel pix = graphic.Get(x, y);
+      if (!opaque) {
+        pix.Opacify(bg);
+      }
+      Bin& bin = histogram[BinOf(pix)];
+      ++bin.count;
+      bin.sum[0] += ToByte(pix.red());
+      bin.sum[1] += ToByte(pix.green());
+      bin.sum[2] += ToByte(pix.blue());
+    }
+  }
+  std::vector<Bin> bins;
+  for (int n = 0; n < kBins; ++n) {
+    if (histogram[n].count) {
+      bins.push_back(histogram[n]);
+      bins.back().color = n;
+    }
+  }
+  if (bins.empty()) {
+    bins.push_back({BinOf(bg), 1, {static_cast<uint64_t>(ToByte(bg.red())),
+                                   static_cast<uint64_t>(ToByte(bg.green())),
+                                   static_cast<uint64_t>(ToByte(bg.blue()))}});
+  }
+
+  // Keep splitting whichever box has the most pixels spread over the widest
+  // range, at the median pixel along that range.
+  std::vector<Box> boxes = {MakeBox(bins, 0, bins.size())};
+  while (static_cast<int>(boxes.size()) < colors) {
+    int pick = -1;
+    double best = 0.0;
+    for (int n = 0; n < static_cast<int>(boxes.size()); ++n) {
+      double score = static_cast<double>(boxes[n].count) * boxes[n].range;
+      if (boxes[n].end - boxes[n].begin > 1 && score > best) {
+        best = score;
+        pick = n;
+      }
+    }
+    if (pick < 0) {
+      break;
+    }
+    Box box = boxes[pick];
+    int axis = box.axis;
+    std::sort(bins.begin() + box.begin, bins.begin() + box.end,
+              [axis](const Bin& a, const Bin& b) {
+                return Channel(a.color, axis) < Channel(b.color, axis);
+              });
+    int mid = box.begin;
+    uint64_t seen = 0;
+    while (mid < box.end - 1 && seen + bins[mid].count <= box.count / 2) {
+      seen += bins[mid++].count;
+    }
+    mid = std::max(mid, box.begin + 1);
+    boxes[pick] = MakeBox(bins, box.begin, mid);
+    boxes.push_back(MakeBox(bins, mid, box.end));
+  }
+
+  for (const Box& box : boxes) {
+    double sum[3] = {0, 0, 0};
+    for (int n = box.begin; n < box.end; ++n) {
+      for (int axis = 0; axis < 3; ++axis) {
+        sum[axis] += bins[n].sum[axis];
+      }
+    }
+    colors_.push_back(Pixel(sum[0] / box.count / 255.0,
+                            sum[1] / box.count / 255.0,
+                            sum[2] / box.count / 255.0));
+  }
+  palette_ = Palette(colors_);
+}
+
+uint8_t AdaptivePalette::Map(const Pixel& pix) const {
+  int bin = BinOf(pix);
+  uint16_t index = lookup_[bin].load(std::memory_order_relaxed);
+  if (index == kUnknown) {
+    // Racing threads will all compute the same answer, so it's fine if more
+    // than one of them does.
+    index = palette_.Nearest(
+        Pixel(Channel(bin, 0), Channel(bin, 1), Channel(bin, 2)));
+    lookup_[bin].store(index, std::memory_order_relaxed);
+  }
+  return index;
+}
+
+// For Emacs:
+// Local Variables:
+// mode:c++
+// indent-tabs-mode:nil
+// tab-width:2
+// c-basic-offset:2
+// c-file-style: nil
+// End:
+// For VIM:
+// vim:set expandtab softtabstop=2 shiftwidth=2 tabstop=2:
@@ -93,6 +93,8 @@ Graphic Movie::Next() {
     }
     av_packet_unref(&packet);
   }
+  delay_ = frame_->pkt_duration *
+      av_q2d(format_->streams[video_stream_]->time_base);
 
   // Convert Raw to RGB.
   sws_scale(sws_, frame_->data,
@@ -112,7 +114,16 @@ Graphic Movie::Next() {
     }
   }
   CHECK(static_cast<int>(pixels.size()) == width_ * height_);
-  return Graphic(width_, height_, std::move(pixels));
+  Graphic res(width_, height_, std::move(pixels));
+  res.set_opaque(true);
+  return res;
+}
+
+void Movie::Rewind() {
+  CHECK_GE(av_seek_frame(format_, video_stream_, 0, AVSEEK_FLAG_BACKWARD), 0)
+      << "Failed to rewind movie.";
+  avcodec_flush_buffers(context_);
+  done_ = false;
 }
 
 void Movie::InitializeMain() {
@@ -0,0 +1,244 @@
+// hiptext - Image to Text Converter
+// By Justine Tunney
+
+#include "hiptext/palette.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+#include <glog/logging.h>
+
+#include "hiptext/pixel.h"
+
+namespace {
+
+struct LinearTable {
+  LinearTable() {
+    for (int n = 0; n < 256; ++n) {
+      double c = n / 255.0;
+      value[n] = (c <= 0.04045) ? c / 12.92
+                                : std::pow((c + 0.055) / 1.055, 2.4);
+    }
+  }
+  double value[256];
+};
+
+// std::cbrt() for the [0, 1] range RGBToOKLab() needs, which is several times
+// faster. Dividing the exponent by three gets within a few percent, and two
+// of Halley's steps, which triple the correct digits, take it to within a
+// few ulps.
+inline double CubeRoot(double x) {
+  if (x <= 0.0) {
+    return 0.0;
+  }
+  uint64_t bits;
+  memcpy(&bits, &x, sizeof(bits));
+  bits = bits / 3 + 0x2a9f7893782da1ceull;
+  double y;
+  memcpy(&y, &bits, sizeof(y));
+  for (int n = 0; n < 2; ++n) {
+    double y3 = y * y * y;
+    y *= (y3 + 2.0 * x) / (2.0 * y3 + x);
+  }
+  return y;
+}
+
+}  // namespace
+
+void RGBToOKLab(const Pixel& pix, double lab[3]) {
+  static const LinearTable linear;
+  double r = linear.value[ToByte(pix.red())];
+  double g = linear.value[ToByte(pix.green())];
+  double b = linear.value[ToByte(pix.blue())];
+  double l = CubeRoot(0.4122214708 * r + 0.5363325363 * g + 0.0514459929 * b);
+  double m = CubeRoot(0.2119034982 * r + 0.6806995451 * g + 0.1073969566 * b);
+  double s = CubeRoot(0.0883024619 * r + 0.2817188376 * g + 0.6299787005 * b);
+  lab[0] = 0.2104542553 * l + 0.7936177850 * m - 0.0040720468 * s;
+  lab[1] = 1.9779984951 * l - 2.4285922050 * m + 0.4505937099 * s;
+  lab[2] = 0.0259040371 * l + 0.7827717662 * m - 0.8086757660 * s;
+}
+
+Palette::Palette(const Pixel* begin, const Pixel* end, ColorSpace space)
+    : space_(space) {
+  for (const Pixel* pix = begin; pix != end; ++pix) {
+    Point point;
+    Convert(*pix, point.v);
+    point.index = static_cast<int>(pix - begin);
+    points_.push_back(point);
+  }
+  std::vector<Point> points = points_;
+  nodes_.reserve(points.size());
+  root_ = Build(&points, 0, size());
+}
+
+Palette::Palette(const std::vector<Pixel>& colors, ColorSpace space)
+    : Palette(colors.data(), colors.data() + colors.size(), space) {}
+
+void Palette::Convert(const Pixel& pix, double v[3]) const {
+  switch (space_) {
+    case ColorSpace::kRGB:
+      v[0] = pix.red();
+      v[1] = pix.green();
+      v[2] = pix.blue();
+      break;
+    case ColorSpace::kOKLab:
+      RGBToOKLab(pix, v);
+      break;
+  }
+}
+
+// Recursively splits points[begin,end) on the median of whichever component
+// has the widest spread. Returns the new node or -1 if the range is empty.
+int Palette::Build(std::vector<Point>* points, int begin, int end) {
+  if (begin == end) {
+    return -1;
+  }
+  Point* p = points->data();
+  int axis = 0;
+  double widest = -1.0;
+  for (int k = 0; k < 3; ++k) {
+    double lo = p[begin].v[k];
+    double hi = lo;
+    for (int n = begin + 1; n < end; ++n) {
+      lo = std::min(lo, p[n].v[k]);
+      hi = std::max(hi, p[n].v[k]);
+    }
+    if (hi - lo > widest) {
+      widest = hi - lo;
+      axis = k;
+    }
+  }
+  std::sort(p + begin, p + end,
+            [axis](const Point& a, const Point& b) {
+              return a.v[axis] < b.v[axis];
+            });
+  // Back the split up to the first point equal to the median, so everything
+  // on the left is strictly smaller. Search() relies on this when it prunes.
+  int mid = begin + (end - begin) / 2;
+  while (mid > begin && p[mid - 1].v[axis] == p[mid].v[axis]) {
+    --mid;
+  }
+  int node = static_cast<int>(nodes_.size());
+  nodes_.push_back({p[mid], axis, -1, -1});
+  int left = Build(points, begin, mid);
+  int right = Build(points, mid + 1, end);
+  nodes_[node].left = left;
+  nodes_[node].right = right;
+  return node;
+}
+
+void Palette::Search(int node, const double v[3],
+                     int* best, double* best_dist) const {
+  while (node >= 0) {
+    const Node& n = nodes_[node];
+    double d0 = v[0] - n.point.v[0];
+    double d1 = v[1] - n.point.v[1];
+    double d2 = v[2] - n.point.v[2];
+    double dist = d0 * d0 + d1 * d1 + d2 * d2;
+    if (dist < *best_dist || (dist == *best_dist && n.point.index < *best)) {
+      *best_dist = dist;
+      *best = n.point.index;
+    }
+    double delta = v[n.axis] - n.point.v[n.axis];
+    int near = delta < 0 ? n.left : n.right;
+    int far = delta < 0 ? n.right : n.left;
+    Search(near, v, best, best_dist);
+    // The far side can only win if it's no farther than the best so far. Equal
+    // distances still have to be checked because of the index tie break.
+    if (delta * delta > *best_dist) {
+      return;
+    }
+    node = far;
+  }
+}
+
+int Palette::Nearest(const Pixel& pix, double* distance) const {
+  CHECK_GE(root_, 0) << "empty palette";
+  double v[3];
+  Convert(pix, v);
+  int best = -1;
+  double best_dist = INFINITY;
+  Search(root_, v, &best, &best_dist);
+  if (distance) {
+    *distance = std::sqrt(best_dist);
+  }
+  return best;
+}
+
+void Palette::Save(std::ostream& out) const {
+  int32_t header[4] = {static_cast<int32_t>(space_), size(),
+                       static_cast<int32_t>(nodes_.size()), root_};
+  out.write(reinterpret_cast<const char*>(header), sizeof(header));
+  out.write(reinterpret_cast<const char*>(points_.data()),
+            points_.size() * sizeof(Point));
+  out.write(reinterpret_cast<const char*>(nodes_.data()),
+            nodes_.size() * sizeof(Node));
+}
+
+bool Palette::Load(std::istream& in) {
+  int32_t header[4];
+  if (!in.read(reinterpret_cast<char*>(header), sizeof(header))) {
+    return false;
+  }
+  int count = header[1];
+  if ((header[0] != static_cast<int32_t>(ColorSpace::kRGB) &&
+       header[0] != static_cast<int32_t>(ColorSpace::kOKLab)) ||
+      count < 1 || count > 1 << 16 || header[2] != count ||
+      header[3] < 0 || header[3] >= count) {
+    return false;
+  }
+  std::vector<Point> points(count);
+  std::vector<Node> nodes(count);
+  if (!in.read(reinterpret_cast<char*>(points.data()),
+               count * sizeof(Point)) ||
+      !in.read(reinterpret_cast<char*>(nodes.data()),
+               count * sizeof(Node))) {
+    return false;
+  }
+  // Every node but the root must be the child of exactly one other, so
+  // the tree can't contain cycles.
+  std::vector<int> parents(count);
+  for (const Node& node : nodes) {
+    if (node.axis < 0 || node.axis > 2 ||
+        node.left < -1 || node.left >= count ||
+        node.right < -1 || node.right >= count ||
+        node.point.index < 0 || node.point.index >= count) {
+      return false;
+    }
+    if (node.left >= 0) ++parents[node.left];
+    if (node.right >= 0) ++parents[node.right];
+  }
+  for (int n = 0; n < count; ++n) {
+    if (parents[n] != (n == header[3] ? 0 : 1)) {
+      return false;
+    }
+  }
+  space_ = static_cast<ColorSpace>(header[0]);
+  root_ = header[3];
+  points_ = std::move(points);
+  nodes_ = std::move(nodes);
+  return true;
+}
+
+double Palette::Distance(const Pixel& pix, int index) const {
+  double v[3];
+  Convert(pix, v);
+  const double* c = points_[index].v;
+  return std::sqrt((v[0] - c[0]) * (v[0] - c[0]) +
+                   (v[1] - c[1]) * (v[1] - c[1]) +
+                   (v[2] - c[2]) * (v[2] - c[2]));
+}
+
+// For Emacs:
+// Local Variables:
+// mode:c++
+// indent-tabs-mode:nil
+// tab-width:2
+// c-basic-offset:2
+// c-file-style: nil
+// End:
+// For VIM:
+// vim:set expandtab softtabstop=2 shiftwidth=2 tabstop=2:
@@ -0,0 +1,117 @@
+// hiptext - Image to Text Converter
+// By Justine Tunney
+
+#include "hiptext/parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+DEFINE_int32(threads, 0, "Number of threads to use for decoding and encoding. "
+             "Defaults to 0, in which case it uses one per CPU");
+
+static thread_local bool g_in_worker = false;
+
+namespace {
+
+class ThreadPool {
+ public:
+  explicit ThreadPool(int workers) {
+    for (int n = 0; n < workers; ++n) {
+      threads_.emplace_back(&ThreadPool::Work, this);
+    }
+  }
+
+  void Run(int begin, int end, const std::function<void(int)>& func) {
+    std::unique_lock<std::mutex> lock(run_mutex_);  // One job at a time.
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      func_ = &func;
+      next_ = begin;
+      end_ = end;
+      pending_ = threads_.size();
+      ++generation_;
+    }
+    wake_.notify_all();
+    g_in_worker = true;
+    Drain();
+    g_in_worker = false;
+    std::unique_lock<std::mutex> guard(mutex_);
+    done_.wait(guard, [this]() { return pending_ == 0; });
+  }
+
+ private:
+  void Work() {
+    g_in_worker = true;
+    uint64_t seen = 0;
+    for (;;) {
+      {
+        std::unique_lock<std::mutex> guard(mutex_);
+        wake_.wait(guard, [&]() { return generation_ != seen; });
+        seen = generation_;
+      }
+      Drain();
+      std::lock_guard<std::mutex> guard(mutex_);
+      if (--pending_ == 0) {
+        done_.notify_one();
+      }
+    }
+  }
+
+  void Drain() {
+    for (int n = next_++; n < end_; n = next_++) {
+      (*func_)(n);
+    }
+  }
+
+  std::vector<std::thread> threads_;
+  std::mutex run_mutex_;
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::condition_variable done_;
+  const std::function<void(int)>* func_ = nullptr;
+  std::atomic<int> next_{0};
+  int end_ = 0;
+  size_t pending_ = 0;
+  uint64_t generation_ = 0;
+};
+
+}  // namespace
+
+int GetThreadCount() {
+  if (FLAGS_threads > 0) {
+    return FLAGS_threads;
+  }
+  return std::max(1u, std::thread::hardware_concurrency());
+}
+
+void ParallelFor(int begin, int end, const std::function<void(int)>& func) {
+  int threads = GetThreadCount();
+  if (threads == 1 || end - begin <= 1 || g_in_worker) {
+    for (int n = begin; n < end; ++n) {
+      func(n);
+    }
+    return;
+  }
+  // Workers live for the rest of the process, blocked when there's no work.
+  static ThreadPool* pool = new ThreadPool(threads - 1);
+  pool->Run(begin, end, func);
+}
+
+// For Emacs:
+// Local Variables:
+// mode:c++
+// indent-tabs-mode:nil
+// tab-width:2
+// c-basic-offset:2
+// c-file-style: nil
+// End:
+// For VIM:
+// vim:set expandtab softtabstop=2 shiftwidth=2 tabstop=2:
@@ -2,6 +2,7 @@
 // By Justine Tunney
 
 #include "hiptext/pixel.h"
+#include "hiptext/srgb.h"
 #include <algorithm>
 #include <cmath>
 #include <glog/logging.h>
@@ -90,6 +91,20 @@ Pixel& Pixel::FromYUV() {
   return Clamp();
 }
 
+Pixel& Pixel::ToLinear() {
+  red_ = SrgbToLinear(ToByte(red_));
+  green_ = SrgbToLinear(ToByte(green_));
+  blue_ = SrgbToLinear(ToByte(blue_));
+  return *this;
+}
+
+Pixel& Pixel::FromLinear() {
+  red_ = LinearToSrgb(red_) / 255.0;
+  green_ = LinearToSrgb(green_) / 255.0;
+  blue_ = LinearToSrgb(blue_) / 255.0;
+  return *this;
+}
+
 Pixel& Pixel::Clamp() {
   red_   = max(0.0, min(1.0, red_  ));
   green_ = max(0.0, min(1.0, green_));
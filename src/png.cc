@@ -57,7 +57,9 @@ Graphic LoadPNG(const std::string& path) {
     }
     delete[] row;
   }
-  return Graphic(width, height, std::move(pixels));
+  Graphic res(width, height, std::move(pixels));
+  res.set_opaque(type == PNG_COLOR_TYPE_RGB);
+  return res;
 }
 
 void WritePNG(const Graphic& graphic, const std::string& path) {
@@ -0,0 +1,216 @@
+// hiptext - Image to Text Converter
+// By Justine Tunney
+
+#include "hiptext/rendercache.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <utility>
+#include <vector>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utime.h>
+
+#include <glog/logging.h>
+
+static const int kKeyLength = 16;
+
+// 64-bit FNV-1a, which is plenty for naming cache files.
+static uint64_t Hash(const std::string& data) {
+  uint64_t hash = 0xcbf29ce484222325ull;
+  for (unsigned char ch : data) {
+    hash ^= ch;
+    hash *= 0x100000001b3ull;
+  }
+  return hash;
+}
+
+// Store() writes to '<key>.tmp<pid>' and then renames it into place.
+static const char kTempSuffix[] = ".tmp";
+
+// Temp files older than this aren't being written any more.
+static const time_t kStaleTempSeconds = 5 * 60;
+
+static bool IsKey(const std::string& name) {
+  return (name.size() == kKeyLength &&
+          std::all_of(name.begin(), name.end(), [](unsigned char ch) {
+            return isxdigit(ch) != 0;
+          }));
+}
+
+// Matches the names Store() writes to before renaming.
+static bool IsTemp(const std::string& name) {
+  return (name.size() > kKeyLength + strlen(kTempSuffix) &&
+          IsKey(name.substr(0, kKeyLength)) &&
+          name.compare(kKeyLength, strlen(kTempSuffix), kTempSuffix) == 0);
+}
+
+// Like mkdir -p.
+static bool MakeDirectories(const std::string& dir) {
+  for (size_t n = 1; n <= dir.size(); ++n) {
+    if (n == dir.size() || dir[n] == '/') {
+      std::string part = dir.substr(0, n);
+      if (mkdir(part.c_str(), 0755) != 0 && errno != EEXIST) {
+        PLOG(WARNING) << "mkdir " << part;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+RenderCache::RenderCache(const std::string& dir, int64_t max_bytes)
+    : dir_(dir), max_bytes_(max_bytes) {
+  MakeDirectories(dir_);
+}
+
+std::string RenderCache::PathOf(const std::string& key) const {
+  return dir_ + "/" + key;
+}
+
+std::string RenderCache::Key(const std::string& path,
+                             const std::string& salt) const {
+  struct stat st;
+  if (stat(path.c_str(), &st) != 0) {
+    return "";
+  }
+  std::string id = path;
+  id += '\0';
+  id += std::to_string(st.st_dev) + ":" + std::to_string(st.st_ino) + ":" +
+        std::to_string(st.st_size) + ":" + std::to_string(st.st_mtime);
+  id += '\0';
+  id += salt;
+  char key[kKeyLength + 1];
+  snprintf(key, sizeof(key), "%016llx",
+           static_cast<unsigned long long>(Hash(id)));
+  return key;
+}
+
+bool RenderCache::Replay(const std::string& key, int fd) const {
+  std::string path = PathOf(key);
+  int cfd = open(path.c_str(), O_RDONLY);
+  if (cfd < 0) {
+    return false;
+  }
+  struct stat st;
+  if (fstat(cfd, &st) != 0 || st.st_size == 0) {
+    close(cfd);
+    return false;
+  }
+  void* map = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, cfd, 0);
+  close(cfd);
+  if (map == MAP_FAILED) {
+    PLOG(WARNING) << "mmap " << path;
+    return false;
+  }
+  const char* data = static_cast<const char*>(map);
+  size_t size = st.st_size;
+  while (size) {
+    ssize_t rc = write(fd, data, size);
+    if (rc <= 0) {
+      if (rc < 0 && errno == EINTR)
+        continue;
+      PLOG(ERROR) << "write";
+      break;
+    }
+    data += rc;
+    size -= rc;
+  }
+  munmap(map, st.st_size);
+  // Once anything is out, rendering it again would only print it twice.
+  if (size == static_cast<size_t>(st.st_size)) {
+    return false;
+  }
+  if (!size) {
+    utime(path.c_str(), nullptr);  // Mark as recently used.
+  }
+  return true;
+}
+
+void RenderCache::Store(const std::string& key, const std::string& data) const {
+  std::string path = PathOf(key);
+  std::string temp = path + kTempSuffix + std::to_string(getpid());
+  FILE* fp = fopen(temp.c_str(), "wb");
+  if (!fp) {
+    PLOG(WARNING) << temp;
+    return;
+  }
+  bool ok = fwrite(data.data(), 1, data.size(), fp) == data.size();
+  ok = (fclose(fp) == 0) && ok;
+  if (!ok || rename(temp.c_str(), path.c_str()) != 0) {
+    PLOG(WARNING) << "failed to save " << path;
+    unlink(temp.c_str());
+    return;
+  }
+  Evict();
+}
+
+void RenderCache::Evict() const {
+  DIR* dir = opendir(dir_.c_str());
+  if (!dir) {
+    PLOG(WARNING) << dir_;
+    return;
+  }
+  struct Entry {
+    time_t mtime;
+    int64_t size;
+    std::string path;
+  };
+  std::vector<Entry> entries;
+  int64_t total = 0;
+  time_t now = time(nullptr);
+  while (dirent* ent = readdir(dir)) {
+    bool temp = IsTemp(ent->d_name);
+    if (!temp && !IsKey(ent->d_name))
+      continue;
+    std::string path = PathOf(ent->d_name);
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0 || !S_ISREG(st.st_mode))
+      continue;
+    if (temp) {
+      // Ones still being written count toward the budget but can't go.
+      if (now - st.st_mtime > kStaleTempSeconds && unlink(path.c_str()) == 0) {
+        LOG(INFO) << "Removed stale " << path;
+      } else {
+        total += st.st_size;
+      }
+      continue;
+    }
+    entries.push_back({st.st_mtime, static_cast<int64_t>(st.st_size),
+                       std::move(path)});
+    total += st.st_size;
+  }
+  closedir(dir);
+  if (total <= max_bytes_) {
+    return;
+  }
+  std::sort(entries.begin(), entries.end(),
+            [](const Entry& a, const Entry& b) { return a.mtime < b.mtime; });
+  for (const Entry& entry : entries) {
+    if (total <= max_bytes_)
+      break;
+    if (unlink(entry.path.c_str()) == 0) {
+      LOG(INFO) << "Evicted " << entry.path;
+      total -= entry.size;
+    }
+  }
+}
+
+// For Emacs:
+// Local Variables:
+// mode:c++
+// indent-tabs-mode:nil
+// tab-width:2
+// c-basic-offset:2
+// c-file-style: nil
+// End:
+// For VIM:
+// vim:set expandtab softtabstop=2 shiftwidth=2 tabstop=2:
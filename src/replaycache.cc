@@ -0,0 +1,72 @@
+// hiptext - Image to Text Converter
+// By Justine Tunney
+
+#include "hiptext/replaycache.h"
+
+#include <algorithm>
+#include <thread>
+#include <utility>
+
+#include <glog/logging.h>
+
+// How often Play() checks whether it should stop while waiting out a frame.
+static const std::chrono::milliseconds kStopCheck(20);
+
+void ReplayCache::Record(std::string bytes, double delay) {
+  if (overflowed_ || !Reserve(bytes.size())) {
+    return;
+  }
+  Clock::duration duration = std::chrono::duration_cast<Clock::duration>(
+      std::chrono::duration<double>(delay));
+  frames_.push_back(Frame{std::move(bytes), duration});
+}
+
+void ReplayCache::Finish(std::string first) {
+  if (frames_.empty()) {
+    return;
+  }
+  bytes_ -= frames_.front().bytes.size();
+  if (Reserve(first.size())) {
+    frames_.front().bytes = std::move(first);
+  }
+}
+
+bool ReplayCache::Reserve(size_t size) {
+  bytes_ += size;
+  if (bytes_ > budget_) {
+    LOG(INFO) << "Replay cache exceeded " << budget_ << " bytes; giving up.";
+    overflowed_ = true;
+    std::vector<Frame>().swap(frames_);
+    return false;
+  }
+  return true;
+}
+
+void ReplayCache::Play(std::ostream& out, const volatile bool* stop) const {
+  Clock::time_point deadline = Clock::now();
+  for (const Frame& frame : frames_) {
+    if (*stop) {
+      return;
+    }
+    out.write(frame.bytes.data(), frame.bytes.size());
+    out.flush();
+    deadline += frame.delay;
+    // Animated images can hold a frame for seconds, and Ctrl-C shouldn't
+    // have to wait that out.
+    for (Clock::time_point now = Clock::now(); now < deadline && !*stop;
+         now = Clock::now()) {
+      std::this_thread::sleep_until(std::min(deadline, now + kStopCheck));
+    }
+  }
+}
+
+// For Emacs:
+// Local Variables:
+// mode:c++
+// indent-tabs-mode:nil
+// tab-width:2
+// c-basic-offset:2
+// c-file-style: nil
+// End:
+// For VIM:
+// vim:set expandtab softtabstop=2 shiftwidth=2 tabstop=2:
@@ -3,62 +3,35 @@
 
 #include "hiptext/sixelprinter.h"
 #include "hiptext/xterm256.h"
+#include "hiptext/parallel.h"
 #include "hiptext/pixel.h"
 
-#include <cstring>
+#include <algorithm>
 #include <iostream>
+#include <string>
+#include <vector>
 
 #include <glog/logging.h>
 
-SixelPrinter::SixelPrinter(std::ostream& out, int colors,
-                           bool is8bit, bool bgprint, int bg)
-    :out_(out), colors_(colors), is8bit_(is8bit), bgprint_(bgprint)
-    , bg_(bg), cache_(colors), count_(0), sixel_offset_(1) {
-  if (colors > 2) {
-    memset(slots_, 0, sizeof(slots_));
+static void AppendRun(std::string* out, char c, int count) {
+  if (count > 3) {
+    *out += '!';  // emit DECGRI (Graphics Repeat Introducer)
+    *out += std::to_string(count);
+    *out += c;
+  } else {
+    out->append(count, c);
   }
 }
 
-void SixelPrinter::PrintPixel(int n) {
-  char c;
-  // TODO(saitoha): smarter compression (now simple run-length compression only)
-  if (count_ == 0) {
-    cache_ = n;
-    count_ = 1;
-  } else if (count_ < 0xff && cache_ == n) {
-    ++count_;
-  } else {  // 16 color or 256 color
-    if (colors_ > 2) {
-      if (!bgprint_ && cache_ == bg_) {
-        c = 0x3f;  // transparent pixel
-      } else {
-        c = 0x3f + sixel_offset_;
-      }
-      if (slots_[cache_] == 0) {
-        DefineColor(cache_);
-        slots_[cache_] = 1;  // set dirty
-      }
-      out_ << '#' << cache_;  // choose color
-    } else {  // monochrome
-      if (cache_ == 0) {
-        c = 0x3f;  // transparent pixel
-      } else {
-        c = 0x3f + sixel_offset_;
-      }
-    }
-    cache_ = n;
-    if (count_ > 2) {
-      out_ << '!'  // emit DECGRI (Graphics Repeat Introducer)
-           << count_;
-    } else if (count_ == 2) {
-      out_ << c;
-    }
-    out_ << c;
-    count_ = 1;
-  }
+SixelPrinter::SixelPrinter(std::ostream& out, int colors,
+                           bool is8bit, bool bgprint, int bg,
+                           const Pixel* palette)
+    : out_(out), palette_(palette ? palette : g_xterm), colors_(colors),
+      is8bit_(is8bit), bgprint_(bgprint), bg_(bg) {
+  CHECK(2 <= colors && colors <= 256);
 }
 
-void SixelPrinter::Start() {
+void SixelPrinter::Start(bool overlay) {
   // emit a DCS (Device Control String) introducer
   if (is8bit_) {
     out_ << '\x90';
@@ -66,14 +39,11 @@ void SixelPrinter::Start() {
     out_ << "\033P";
   }
 
-  out_ << "0;0;8q"  // emit SIXEL identifier
+  out_ << (overlay ? "0;1;8q" : "0;0;8q")  // emit SIXEL identifier
        << "\"1;1";  // specify aspect ratio
 }
 
 void SixelPrinter::End() {
-  if (sixel_offset_ != 1) {
-    out_ << '-';  // emit the last DECGNL (Graphics Next Line)
-  }
   // emit a ST (String Terminator)
   if (is8bit_) {
     out_ << '\x9c';
@@ -82,27 +52,106 @@ void SixelPrinter::End() {
   }
 }
 
-void SixelPrinter::LineFeed() {
-  if (count_ > 0) {
-    PrintPixel(colors_);
+void SixelPrinter::PrintBands(const uint8_t* codes, int width, int height,
+                              int stride) {
+  if (stride == 0) {
+    stride = width;
+  }
+  // Once the registers are known, bands don't depend on one another, so
+  // each one is encoded into its own buffer on the thread pool.
+  int bands = (height + 5) / 6;
+  std::vector<std::string> data(bands);
+  std::vector<std::bitset<256>> used(bands);
+  ParallelFor(0, bands, [&](int band) {
+    int y = band * 6;
+    EncodeBand(codes + y * stride, width, std::min(6, height - y), stride,
+               &data[band], &used[band]);
+  });
+  if (colors_ > 2) {
+    std::bitset<256> all;
+    for (const auto& band : used) {
+      all |= band;
+    }
+    for (int code = 0; code < colors_; ++code) {
+      if (all[code] && !defined_[code]) {
+        DefineColor(code);
+      }
+    }
+    defined_ |= all;
+  }
+  for (const std::string& band : data) {
+    out_ << band;
   }
+}
 
-  if (sixel_offset_ == 1 << 5) {
-    out_ << '$';  // for old mlterm (<= 3.3.1)
-    out_ << '-';  // emit DECGNL (Graphics Next Line)
-    sixel_offset_ = 1;  // reset sixel offset
-  } else {
-    out_ << '$';  // emit DECGCR (Graphics Carriage Return)
-    sixel_offset_ <<= 1;  // increment sixel offset
+void SixelPrinter::EncodeBand(const uint8_t* codes, int width, int rows,
+                              int stride, std::string* out,
+                              std::bitset<256>* used) const {
+  DCHECK(1 <= rows && rows <= 6);
+  // Sixel bits for each color and column. This is all zeroes between calls,
+  // so only the colors that were used need clearing.
+  static thread_local std::vector<uint8_t> masks;
+  bool mono = colors_ == 2;
+  int planes = mono ? 1 : colors_;
+  if (masks.size() < static_cast<size_t>(planes * width)) {
+    masks.resize(planes * width);
   }
+  bool present[256] = {};
 
-  // reset states
-  count_ = 0;
-  cache_ = colors_;
+  // Gather the six bits of every column into a mask per color, leaving out
+  // pixels that are the same as the terminal background.
+  for (int row = 0; row < rows; ++row) {
+    const uint8_t* line = codes + row * stride;
+    for (int x = 0; x < width; ++x) {
+      int code = line[x];
+      if (mono) {
+        if (code == 0) continue;
+        code = 0;
+      } else if (!bgprint_ && code == bg_) {
+        continue;
+      }
+      DCHECK_LT(code, planes);
+      masks[code * width + x] |= 1 << row;
+      present[code] = true;
+    }
+  }
+
+  bool first = true;
+  for (int code = 0; code < planes; ++code) {
+    if (!present[code]) {
+      continue;
+    }
+    if (!first) {
+      *out += '$';  // emit DECGCR (Graphics Carriage Return)
+    }
+    first = false;
+    if (!mono) {
+      used->set(code);
+      *out += '#';  // choose color
+      *out += std::to_string(code);
+    }
+    // Trailing empty columns can simply be left off.
+    uint8_t* mask = &masks[code * width];
+    int end = width;
+    while (end > 0 && mask[end - 1] == 0) {
+      --end;
+    }
+    int x = 0;
+    while (x < end) {
+      int run = 1;
+      while (x + run < end && mask[x + run] == mask[x]) {
+        ++run;
+      }
+      AppendRun(out, static_cast<char>(0x3f + mask[x]), run);
+      x += run;
+    }
+    std::fill(mask, mask + width, 0);
+  }
+  *out += '-';  // emit DECGNL (Graphics Next Line)
 }
 
 void SixelPrinter::DefineColor(int n) {
-  const Pixel *pix = g_xterm + n;
+  const Pixel *pix = palette_ + n;
 
   // emit a palette definition
   out_ << '#' << n  // specify palette No.
@@ -116,7 +165,6 @@ void SixelPrinter::DefineColor(int n) {
        << static_cast<int>(pix->blue() * 100);
 }
 
-
 // For Emacs:
 // Local Variables:
 // mode:c++
@@ -0,0 +1,224 @@
+// hiptext - Image to Text Converter
+// By Justine Tunney
+
+#include "hiptext/sixelrenderer.h"
+
+#include <algorithm>
+#include <bitset>
+#include <cstdint>
+#include <vector>
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include "hiptext/artiste.h"
+#include "hiptext/dither.h"
+#include "hiptext/graphic.h"
+#include "hiptext/mediancut.h"
+#include "hiptext/pixel.h"
+#include "hiptext/sixelprinter.h"
+#include "hiptext/xterm256.h"
+
+DEFINE_bool(sixel_adaptive, true, "Pick the SIXEL color registers to suit "
+            "each image, rather than using the xterm palette. Use "
+            "--nosixel_adaptive for the old behavior");
+DEFINE_bool(sixel_incremental, true, "When playing video with SIXEL, only "
+            "send the parts of each frame that changed, and keep the same "
+            "color registers from one frame to the next. Turn this off for "
+            "terminals that forget registers between images");
+DECLARE_string(bg);
+DECLARE_bool(bgprint);
+
+namespace {
+
+// How much worse than when it was chosen an adaptive palette may fit a video
+// frame before it's replaced.
+const double kPaletteSlack = 1.5;
+const double kPaletteTolerance = 2.0 / 255.0;
+
+// How close an adaptive palette color must be to --bg to be left undrawn.
+const double kBackgroundTolerance = 4.0 / 255.0;
+
+// Returns the average distance from pixels to their palette colors, measured
+// on a grid of at most 64x64 samples.
+double MeanError(const AdaptivePalette& palette, const Graphic& graphic) {
+  int xstep = std::max(1, graphic.width() / 64);
+  int ystep = std::max(1, graphic.height() / 64);
+  double total = 0.0;
+  int count = 0;
+  for (int y = ystep / 2; y < graphic.height(); y += ystep) {
+    for (int x = xstep / 2; x < graphic.width(); x += xstep) {
+      const Pixel& pix = graphic.Get(x, y);
+      total += pix.Distance(palette.colors()[palette.Map(pix)]);
+      ++count;
+    }
+  }
+  return count ? total / count : 0.0;
+}
+
+}  // namespace
+
+struct SixelRenderer::State {
+  std::unique_ptr<AdaptivePalette> adaptive;
+  double adaptive_error = 0.0;  // MeanError() when 'adaptive' was chosen.
+  std::bitset<256> defined;     // Registers the terminal already has.
+  std::vector<uint8_t> codes;   // The frame on the screen, if playing video.
+  int width = 0;
+  int height = 0;
+};
+
+SixelRenderer::SixelRenderer(int colors)
+    : colors_(colors), state_(std::make_shared<State>()) {
+  CHECK(colors == 2 || colors == 16 || colors == 256);
+}
+
+void SixelRenderer::operator()(std::ostream& os, const Graphic& graphic) {
+  static const Pixel kMonochrome[2] = {Pixel::kBlack, Pixel::kWhite};
+  State& state = *state_;
+  Pixel bg = Pixel(FLAGS_bg);
+  int width = graphic.width();
+  int height = graphic.height();
+  bool video = FLAGS_sixel_incremental && IsPlayingVideo();
+  // Monochrome can only draw pixels that are on, so it can't patch frames.
+  bool repaint = (!video || colors_ == 2 ||
+                  width != state.width || height != state.height);
+
+  // Choose registers and quantize.
+  std::vector<uint8_t> codes;
+  int bg_code = 0;
+  if (colors_ == 2) {
+    auto quantize = [](const Pixel& pix) -> uint8_t {
+      return pix.grey() >= 0.5;
+    };
+    Ditherer ditherer(GetDitherMode(), PerPixel(quantize), kMonochrome, 0, 2);
+    codes = ditherer.Quantize(graphic);
+  } else if (FLAGS_sixel_adaptive) {
+    if (!video || !state.adaptive ||
+        MeanError(*state.adaptive, graphic) >
+            state.adaptive_error * kPaletteSlack + kPaletteTolerance) {
+      state.adaptive.reset(new AdaptivePalette(graphic, bg, colors_));
+      state.adaptive_error = MeanError(*state.adaptive, graphic);
+      state.defined.reset();
+      repaint = true;
+    }
+    const AdaptivePalette& palette = *state.adaptive;
+    Ditherer ditherer(GetDitherMode(),
+                      PerPixel([&](const Pixel& pix) {
+                        return palette.Map(pix);
+                      }),
+                      palette.colors().data(), 0, palette.colors().size());
+    codes = ditherer.Quantize(graphic);
+    // Pixels can only be left for the terminal background to show through if
+    // the palette actually has something close to the background color.
+    bg_code = palette.Map(bg);
+    if (bg.Distance(palette.colors()[bg_code]) > kBackgroundTolerance) {
+      bg_code = -1;
+    }
+  } else {
+    state.adaptive.reset();
+    auto quantize = (colors_ == 256) ? rgb_to_xterm256 : rgb_to_xterm16;
+    Ditherer ditherer(GetDitherMode(), PerPixel(quantize),
+                      g_xterm, (colors_ == 256) ? 16 : 0, colors_);
+    codes = ditherer.Quantize(graphic);
+    bg_code = quantize(bg);
+  }
+  const Pixel* registers = nullptr;
+  if (colors_ == 2) {
+    registers = kMonochrome;
+  } else if (state.adaptive) {
+    registers = state.adaptive->colors().data();
+  }
+  if (!video) {
+    state.defined.reset();
+  }
+  int cell_width;
+  int cell_height;
+  if (!repaint && !GetCellSize(&cell_width, &cell_height)) {
+    repaint = true;
+  }
+
+  if (repaint) {
+    SixelPrinter out(os, colors_, false, FLAGS_bgprint && colors_ > 2,
+                     bg_code, registers);
+    out.set_defined(state.defined);
+    out.Start();
+    out.PrintBands(codes.data(), width, height);
+    out.End();
+    state.defined = out.defined();
+  } else {
+    // Find runs of character rows containing changes, and redraw the cells
+    // spanning the changed columns of each. The cursor can only be placed on
+    // cell boundaries, and every pixel in the patch is painted so nothing
+    // from the old frame shows through.
+    int rows = (height + cell_height - 1) / cell_height;
+    // Widens [x0,x1) to cover the changes in 'row', if there are any.
+    auto changed = [&](int row, int* x0, int* x1) {
+      bool found = false;
+      int y1 = std::min(height, (row + 1) * cell_height);
+      for (int y = row * cell_height; y < y1; ++y) {
+        const uint8_t* a = &codes[y * width];
+        const uint8_t* b = &state.codes[y * width];
+        int left = 0;
+        while (left < width && a[left] == b[left]) {
+          ++left;
+        }
+        if (left == width) {
+          continue;
+        }
+        int right = width;
+        while (a[right - 1] == b[right - 1]) {
+          --right;
+        }
+        *x0 = std::min(*x0, left);
+        *x1 = std::max(*x1, right);
+        found = true;
+      }
+      return found;
+    };
+    for (int row = 0; row < rows;) {
+      int x0 = width;
+      int x1 = 0;
+      if (!changed(row, &x0, &x1)) {
+        ++row;
+        continue;
+      }
+      int end = row + 1;
+      while (end < rows && changed(end, &x0, &x1)) {
+        ++end;
+      }
+      x0 = x0 / cell_width * cell_width;
+      x1 = std::min(width, (x1 + cell_width - 1) / cell_width * cell_width);
+      int y0 = row * cell_height;
+      int y1 = std::min(height, end * cell_height);
+      os << "\x1b[" << row + 1 << ";" << x0 / cell_width + 1 << "H";
+      SixelPrinter out(os, colors_, false, true, bg_code, registers);
+      out.set_defined(state.defined);
+      out.Start(true);
+      out.PrintBands(&codes[y0 * width + x0], x1 - x0, y1 - y0, width);
+      out.End();
+      state.defined = out.defined();
+      row = end;
+    }
+  }
+
+  if (video) {
+    state.codes = std::move(codes);
+    state.width = width;
+    state.height = height;
+  } else {
+    state.codes.clear();
+    state.width = 0;
+    state.height = 0;
+  }
+}
+
+// For Emacs:
+// Local Variables:
+// mode:c++
+// indent-tabs-mode:nil
+// tab-width:2
+// c-basic-offset:2
+// c-file-style: nil
+// End:
+// For VIM:
+// vim:set expandtab softtabstop=2 shiftwidth=2 tabstop=2:
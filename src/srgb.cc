@@ -0,0 +1,65 @@
+// hiptext - Image to Text Converter
+// By Justine Tunney
+
+#include "hiptext/srgb.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+const int kLinearSteps = 4096;
+
+double Decode(double value) {
+  return (value <= 0.04045
+          ? value / 12.92
+          : std::pow((value + 0.055) / 1.055, 2.4));
+}
+
+double Encode(double value) {
+  return (value <= 0.0031308
+          ? value * 12.92
+          : 1.055 * std::pow(value, 1.0 / 2.4) - 0.055);
+}
+
+struct Tables {
+  float to_linear[256];
+  uint8_t to_srgb[kLinearSteps];
+
+  Tables() {
+    for (int n = 0; n < 256; ++n) {
+      to_linear[n] = Decode(n / 255.0);
+    }
+    for (int n = 0; n < kLinearSteps; ++n) {
+      to_srgb[n] = static_cast<uint8_t>(
+          Encode(n / (kLinearSteps - 1.0)) * 255.0 + 0.5);
+    }
+  }
+};
+
+const Tables& GetTables() {
+  static const Tables* tables = new Tables;
+  return *tables;
+}
+
+}  // namespace
+
+float SrgbToLinear(uint8_t code) {
+  return GetTables().to_linear[code];
+}
+
+uint8_t LinearToSrgb(double linear) {
+  double step = std::max(0.0, std::min(1.0, linear)) * (kLinearSteps - 1);
+  return GetTables().to_srgb[static_cast<int>(step + 0.5)];
+}
+
+// For Emacs:
+// Local Variables:
+// mode:c++
+// indent-tabs-mode:nil
+// tab-width:2
+// c-basic-offset:2
+// c-file-style: nil
+// End:
+// For VIM:
+// vim:set expandtab softtabstop=2 shiftwidth=2 tabstop=2:
@@ -0,0 +1,250 @@
+// hiptext - Image to Text Converter
+// By Justine Tunney
+
+#include "hiptext/subcell.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include "hiptext/graphic.h"
+#include "hiptext/parallel.h"
+#include "hiptext/pixel.h"
+#include "hiptext/termprinter.h"
+#include "hiptext/unicode.h"
+#include "hiptext/xterm256.h"
+
+DECLARE_string(space);
+DECLARE_bool(truecolor);
+
+namespace {
+
+const int kMaxPixels = 8;
+
+// How many rounds of k-means to run after the initial split.
+const int kRefinements = 2;
+
+inline double Square(double value) {
+  return value * value;
+}
+
+// A color as either an xterm256 code or 0xRRGGBB.
+inline int ToColor(const Pixel& pix) {
+  if (FLAGS_truecolor) {
+    return ToByte(pix.red()) << 16 | ToByte(pix.green()) << 8 |
+           ToByte(pix.blue());
+  }
+  return rgb_to_xterm256(pix);
+}
+
+struct Cell {
+  int mask;
+  int fg;
+  int bg;
+};
+
+// Draws 'graphic' in cells two pixels wide and 'rows' pixels tall.
+void PrintImageSubcells(std::ostream& os, const Graphic& graphic, int rows,
+                        wchar_t (*glyph)(int)) {
+  int count = 2 * rows;
+  int cols = graphic.width() / 2;
+  int lines = graphic.height() / rows;
+  std::vector<std::string> glyphs(1 << count);
+  for (int mask = 0; mask < (1 << count); ++mask) {
+    glyphs[mask] = EncodeText(glyph(mask));
+  }
+
+  // Fitting is where the time goes, so do that on the thread pool.
+  std::vector<Cell> cells(cols * lines);
+  ParallelFor(0, lines, [&](int line) {
+    Pixel pixels[kMaxPixels];
+    for (int col = 0; col < cols; ++col) {
+      for (int y = 0; y < rows; ++y) {
+        for (int x = 0; x < 2; ++x) {
+          pixels[y * 2 + x] = graphic.Get(col * 2 + x, line * rows + y);
+        }
+      }
+      Pixel fg_pix;
+      Pixel bg_pix;
+      Cell& cell = cells[line * cols + col];
+      cell.mask = FitCell(pixels, count, &fg_pix, &bg_pix);
+      cell.fg = ToColor(fg_pix);
+      cell.bg = ToColor(bg_pix);
+    }
+  });
+
+  TermPrinter out(os);
+  for (int line = 0; line < lines; ++line) {
+    for (int col = 0; col < cols; ++col) {
+      const Cell& cell = cells[line * cols + col];
+      if (FLAGS_truecolor) {
+        out.SetBackgroundRGB(cell.bg >> 16, cell.bg >> 8 & 255,
+                             cell.bg & 255);
+      } else {
+        out.SetBackground256(cell.bg);
+      }
+      if (!cell.mask || cell.fg == cell.bg) {
+        out << FLAGS_space;
+        continue;
+      }
+      if (FLAGS_truecolor) {
+        out.SetForegroundRGB(cell.fg >> 16, cell.fg >> 8 & 255,
+                             cell.fg & 255);
+      } else {
+        out.SetForeground256(cell.fg);
+      }
+      out << glyphs[cell.mask];
+    }
+    out.Reset();
+    out << "\n";
+  }
+}
+
+}  // namespace
+
+int FitCell(const Pixel* pixels, int count, Pixel* fg, Pixel* bg) {
+  DCHECK(1 <= count && count <= kMaxPixels);
+  double color[kMaxPixels][3];
+  double lo[3] = {1.0, 1.0, 1.0};
+  double hi[3] = {0.0, 0.0, 0.0};
+  for (int n = 0; n < count; ++n) {
+    color[n][0] = pixels[n].red();
+    color[n][1] = pixels[n].green();
+    color[n][2] = pixels[n].blue();
+    for (int c = 0; c < 3; ++c) {
+      lo[c] = std::min(lo[c], color[n][c]);
+      hi[c] = std::max(hi[c], color[n][c]);
+    }
+  }
+
+  // Start by splitting across the middle of the channel that varies most,
+  // which is usually right already.
+  int axis = 0;
+  for (int c = 1; c < 3; ++c) {
+    if (hi[c] - lo[c] > hi[axis] - lo[axis]) {
+      axis = c;
+    }
+  }
+  int mask = 0;
+  if (hi[axis] - lo[axis] > 1e-6) {
+    double middle = (lo[axis] + hi[axis]) / 2.0;
+    for (int n = 0; n < count; ++n) {
+      if (color[n][axis] > middle) {
+        mask |= 1 << n;
+      }
+    }
+  }
+
+  // Then refine it with k-means, stopping once it settles.
+  double mean[2][3];
+  for (int round = 0;; ++round) {
+    int size[2] = {0, 0};
+    std::fill(&mean[0][0], &mean[0][0] + 6, 0.0);
+    for (int n = 0; n < count; ++n) {
+      int k = mask >> n & 1;
+      ++size[k];
+      for (int c = 0; c < 3; ++c) {
+        mean[k][c] += color[n][c];
+      }
+    }
+    for (int k = 0; k < 2; ++k) {
+      for (int c = 0; c < 3; ++c) {
+        mean[k][c] = size[k] ? mean[k][c] / size[k] : 0.0;
+      }
+    }
+    if (!mask || round == kRefinements) {
+      break;
+    }
+    int next = 0;
+    for (int n = 0; n < count; ++n) {
+      double d0 = 0.0;
+      double d1 = 0.0;
+      for (int c = 0; c < 3; ++c) {
+        d0 += Square(color[n][c] - mean[0][c]);
+        d1 += Square(color[n][c] - mean[1][c]);
+      }
+      if (d1 < d0) {
+        next |= 1 << n;
+      }
+    }
+    if (next == mask || !next || next == (1 << count) - 1) {
+      break;
+    }
+    mask = next;
+  }
+
+  if (!mask) {
+    std::copy(mean[0], mean[0] + 3, mean[1]);
+  }
+  *fg = Pixel(mean[1][0], mean[1][1], mean[1][2]);
+  *bg = Pixel(mean[0][0], mean[0][1], mean[0][2]);
+  return mask;
+}
+
+wchar_t QuadrantGlyph(int mask) {
+  static const wchar_t kQuadrants[16] = {
+    L' ',      L'\u2598', L'\u259d', L'\u2580',
+    L'\u2596', L'\u258c', L'\u259e', L'\u259b',
+    L'\u2597', L'\u259a', L'\u2590', L'\u259c',
+    L'\u2584', L'\u2599', L'\u259f', L'\u2588',
+  };
+  DCHECK(0 <= mask && mask < 16);
+  return kQuadrants[mask];
+}
+
+wchar_t SextantGlyph(int mask) {
+  DCHECK(0 <= mask && mask < 64);
+  // The sextant block is in bit order, except for the patterns that already
+  // had characters: blank, left half, right half and full.
+  switch (mask) {
+    case 0:
+      return L' ';
+    case 21:
+      return L'\u258c';
+    case 42:
+      return L'\u2590';
+    case 63:
+      return L'\u2588';
+  }
+  return static_cast<wchar_t>(0x1fb00 + mask - 1 - (mask > 21) - (mask > 42));
+}
+
+wchar_t BrailleGlyph(int mask) {
+  // Braille numbers its dots down the left column and then the right, with
+  // the bottom row added as an afterthought.
+  static const int kDots[8] = {0, 3, 1, 4, 2, 5, 6, 7};
+  DCHECK(0 <= mask && mask < 256);
+  int dots = 0;
+  for (int n = 0; n < 8; ++n) {
+    if (mask & (1 << n)) {
+      dots |= 1 << kDots[n];
+    }
+  }
+  return static_cast<wchar_t>(0x2800 + dots);
+}
+
+void PrintImageQuadrants(std::ostream& os, const Graphic& graphic) {
+  PrintImageSubcells(os, graphic, 2, QuadrantGlyph);
+}
+
+void PrintImageSextants(std::ostream& os, const Graphic& graphic) {
+  PrintImageSubcells(os, graphic, 3, SextantGlyph);
+}
+
+void PrintImageBraille(std::ostream& os, const Graphic& graphic) {
+  PrintImageSubcells(os, graphic, 4, BrailleGlyph);
+}
+
+// For Emacs:
+// Local Variables:
+// mode:c++
+// indent-tabs-mode:nil
+// tab-width:2
+// c-basic-offset:2
+// c-file-style: nil
+// End:
+// For VIM:
+// vim:set expandtab softtabstop=2 shiftwidth=2 tabstop=2:
@@ -0,0 +1,184 @@
+// hiptext - Image to Text Converter
+// By Justine Tunney
+
+#include "hiptext/summedarea.h"
+
+#include <algorithm>
+#include <vector>
+
+#include <glog/logging.h>
+
+#include "hiptext/graphic.h"
+#include "hiptext/parallel.h"
+#include "hiptext/pixel.h"
+
+namespace {
+
+// Fixed point one.
+const double kOne = 65535.0;
+
+inline uint64_t ToFixed(double value) {
+  return static_cast<uint64_t>(std::max(0.0, std::min(1.0, value)) * kOne +
+                               0.5);
+}
+
+// Where output pixel 'n' of 'size' starts in a source 'length' long.
+inline int Edge(int n, int size, int length) {
+  return static_cast<int64_t>(n) * length / size;
+}
+
+}  // namespace
+
+SummedAreaTable::SummedAreaTable(const Graphic& graphic, bool squares)
+    : width_(graphic.width()),
+      height_(graphic.height()),
+      opaque_(graphic.opaque()),
+      premultiplied_(graphic.premultiplied()),
+      sums_((width_ + 1) * (height_ + 1) * 4),
+      squares_(squares ? sums_.size() : 0) {
+  const int stride = (width_ + 1) * 4;
+  // Running sums along each row don't depend on one another, so those are
+  // done in parallel. The first row and column stay zero.
+  ParallelFor(0, height_, [&](int y) {
+    uint64_t* row = &sums_[(y + 1) * stride];
+    uint64_t* row2 = squares ? &squares_[(y + 1) * stride] : nullptr;
+    uint64_t run[4] = {0, 0, 0, 0};
+    uint64_t run2[4] = {0, 0, 0, 0};
+    for (int x = 0; x < width_; ++x) {
+      const Pixel& pix = graphic.Get(x, y);
+      const uint64_t value[4] = {ToFixed(pix.red()), ToFixed(pix.green()),
+                                 ToFixed(pix.blue()), ToFixed(pix.alpha())};
+      for (int c = 0; c < 4; ++c) {
+        run[c] += value[c];
+        row[(x + 1) * 4 + c] = run[c];
+      }
+      if (row2) {
+        for (int c = 0; c < 4; ++c) {
+          run2[c] += value[c] * value[c];
+          row2[(x + 1) * 4 + c] = run2[c];
+        }
+      }
+    }
+  });
+  // Then each row gets everything above it added in.
+  for (std::vector<uint64_t>* table : {&sums_, &squares_}) {
+    if (table->empty()) {
+      continue;
+    }
+    for (int y = 2; y <= height_; ++y) {
+      const uint64_t* above = &(*table)[(y - 1) * stride];
+      uint64_t* row = &(*table)[y * stride];
+      for (int n = 0; n < stride; ++n) {
+        row[n] += above[n];
+      }
+    }
+  }
+}
+
+void SummedAreaTable::Sum(const std::vector<uint64_t>& table, int x, int y,
+                          int w, int h, uint64_t out[4]) const {
+  DCHECK(0 <= x && 0 < w && x + w <= width_);
+  DCHECK(0 <= y && 0 < h && y + h <= height_);
+  const int stride = (width_ + 1) * 4;
+  const uint64_t* top = &table[y * stride];
+  const uint64_t* bottom = &table[(y + h) * stride];
+  for (int c = 0; c < 4; ++c) {
+    out[c] = (bottom[(x + w) * 4 + c] - bottom[x * 4 + c] -
+              top[(x + w) * 4 + c] + top[x * 4 + c]);
+  }
+}
+
+Pixel SummedAreaTable::Mean(int x, int y, int w, int h) const {
+  uint64_t sum[4];
+  Sum(sums_, x, y, w, h, sum);
+  const double scale = 1.0 / (kOne * w * h);
+  return Pixel(sum[0] * scale, sum[1] * scale, sum[2] * scale,
+               sum[3] * scale);
+}
+
+double SummedAreaTable::Variance(int x, int y, int w, int h) const {
+  CHECK(!squares_.empty()) << "Table was made without squares.";
+  uint64_t sum[4];
+  uint64_t sum2[4];
+  Sum(sums_, x, y, w, h, sum);
+  Sum(squares_, x, y, w, h, sum2);
+  const double count = static_cast<double>(w) * h;
+  double res = 0.0;
+  for (int c = 0; c < 3; ++c) {
+    double mean = sum[c] / count;
+    res += std::max(0.0, sum2[c] / count - mean * mean);
+  }
+  return res / (kOne * kOne);
+}
+
+Graphic AreaScale(const Graphic& graphic, int new_width, int new_height) {
+  const int width = graphic.width();
+  const int height = graphic.height();
+  if (width == new_width && height == new_height) {
+    return graphic;
+  }
+  Graphic res(new_width, new_height);
+  res.set_opaque(graphic.opaque());
+  res.set_premultiplied(graphic.premultiplied());
+  ParallelFor(0, new_height, [&](int y) {
+    int y0 = Edge(y, new_height, height);
+    int y1 = std::max(y0 + 1, Edge(y + 1, new_height, height));
+    // Add up the band of source rows column by column, then turn that into
+    // a running sum so each output pixel is a difference of two entries.
+    static thread_local std::vector<double> run;
+    run.assign((width + 1) * 4, 0.0);
+    for (int sy = y0; sy < y1; ++sy) {
+      double* column = &run[4];
+      for (int x = 0; x < width; ++x, column += 4) {
+        const Pixel& pix = graphic.Get(x, sy);
+        column[0] += pix.red();
+        column[1] += pix.green();
+        column[2] += pix.blue();
+        column[3] += pix.alpha();
+      }
+    }
+    for (int n = 4; n < static_cast<int>(run.size()); ++n) {
+      run[n] += run[n - 4];
+    }
+    for (int x = 0; x < new_width; ++x) {
+      int x0 = Edge(x, new_width, width);
+      int x1 = std::max(x0 + 1, Edge(x + 1, new_width, width));
+      const double scale = 1.0 / ((x1 - x0) * (y1 - y0));
+      const double* left = &run[x0 * 4];
+      const double* right = &run[x1 * 4];
+      res.Get(x, y) = Pixel((right[0] - left[0]) * scale,
+                            (right[1] - left[1]) * scale,
+                            (right[2] - left[2]) * scale,
+                            (right[3] - left[3]) * scale);
+    }
+  });
+  return res;
+}
+
+Graphic AreaScale(const SummedAreaTable& table, int new_width,
+                  int new_height) {
+  Graphic res(new_width, new_height);
+  res.set_opaque(table.opaque());
+  res.set_premultiplied(table.premultiplied());
+  ParallelFor(0, new_height, [&](int y) {
+    int y0 = Edge(y, new_height, table.height());
+    int y1 = std::max(y0 + 1, Edge(y + 1, new_height, table.height()));
+    for (int x = 0; x < new_width; ++x) {
+      int x0 = Edge(x, new_width, table.width());
+      int x1 = std::max(x0 + 1, Edge(x + 1, new_width, table.width()));
+      res.Get(x, y) = table.Mean(x0, y0, x1 - x0, y1 - y0);
+    }
+  });
+  return res;
+}
+
+// For Emacs:
+// Local Variables:
+// mode:c++
+// indent-tabs-mode:nil
+// tab-width:2
+// c-basic-offset:2
+// c-file-style: nil
+// End:
+// For VIM:
+// vim:set expandtab softtabstop=2 shiftwidth=2 tabstop=2:
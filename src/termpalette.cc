@@ -0,0 +1,229 @@
+// hiptext - Image to Text Converter
+// By Justine Tunney
+
+#include "hiptext/termpalette.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+#include <fcntl.h>
+#include <sys/select.h>
+#include <sys/stat.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include "hiptext/pixel.h"
+#include "hiptext/xterm256.h"
+
+DEFINE_bool(termpalette, false, "Ask the terminal what its 256 colors really "
+            "are, rather than assuming xterm's defaults. This helps a lot "
+            "with custom color schemes. The answer is cached per $TERM");
+DEFINE_bool(termpalette_refresh, false, "Ignore the --termpalette cache and "
+            "ask the terminal again, e.g. after changing its color scheme");
+DEFINE_int32(termpalette_timeout, 250, "Milliseconds to wait for the terminal "
+             "to answer --termpalette queries");
+
+using std::string;
+
+namespace {
+
+// Reads a component of an X11 color spec like "cdcd", which has one to four
+// hex digits, and scales it to [0,1].
+bool ParseComponent(const char** p, double* value) {
+  unsigned bits = 0;
+  int digits = 0;
+  while (digits < 4 && isxdigit(static_cast<unsigned char>(**p))) {
+    char c = tolower(*(*p)++);
+    bits = bits * 16 + (isdigit(static_cast<unsigned char>(c)) ? c - '0'
+                                                               : c - 'a' + 10);
+    ++digits;
+  }
+  if (digits == 0) {
+    return false;
+  }
+  *value = bits / static_cast<double>((1u << (4 * digits)) - 1);
+  return true;
+}
+
+// Returns where to cache the palette, or an empty string if there's no home.
+string CachePath() {
+  const char* home = getenv("HOME");
+  if (home == nullptr || *home == '\0') {
+    return "";
+  }
+  string term = getenv("TERM") ? getenv("TERM") : "unknown";
+  for (char& c : term) {
+    if (!isalnum(static_cast<unsigned char>(c)) && c != '-' && c != '_') {
+      c = '_';
+    }
+  }
+  return string(home) + "/.cache/hiptext/palette-" + term;
+}
+
+void SaveCache(const string& path) {
+  string dir = path.substr(0, path.rfind('/'));
+  mkdir(dir.substr(0, dir.rfind('/')).c_str(), 0755);
+  if (mkdir(dir.c_str(), 0755) != 0 && errno != EEXIST) {
+    PLOG(WARNING) << "mkdir " << dir;
+    return;
+  }
+  string temp = path + ".tmp" + std::to_string(getpid());
+  {
+    std::ofstream out(temp, std::ios::binary);
+    SaveXtermColors(out);
+    if (!out) {
+      LOG(WARNING) << "Failed to write " << temp;
+      unlink(temp.c_str());
+      return;
+    }
+  }
+  if (rename(temp.c_str(), path.c_str()) != 0) {
+    PLOG(WARNING) << "rename " << path;
+    unlink(temp.c_str());
+  }
+}
+
+}  // namespace
+
+int ParsePaletteReply(const string& reply, Pixel colors[256]) {
+  int found = 0;
+  size_t pos = 0;
+  while ((pos = reply.find("\x1b]4;", pos)) != string::npos) {
+    pos += 4;
+    const char* p = reply.c_str() + pos;
+    char* end;
+    long index = strtol(p, &end, 10);
+    if (end == p || index < 0 || index > 255 || strncmp(end, ";rgb:", 5)) {
+      continue;
+    }
+    p = end + 5;
+    double rgb[3];
+    bool ok = true;
+    for (int k = 0; k < 3 && ok; ++k) {
+      ok = ParseComponent(&p, &rgb[k]) && (k == 2 || *p++ == '/');
+    }
+    if (ok && (*p == '\a' || *p == '\x1b')) {
+      colors[index] = Pixel(rgb[0], rgb[1], rgb[2]);
+      ++found;
+    }
+  }
+  return found;
+}
+
+int QueryTerminalPalette(Pixel colors[256], int timeout_ms) {
+  int fd = open("/dev/tty", O_RDWR | O_NOCTTY);
+  if (fd < 0) {
+    return 0;
+  }
+  termios old_mode;
+  if (tcgetattr(fd, &old_mode) != 0) {
+    close(fd);
+    return 0;
+  }
+  termios raw = old_mode;
+  raw.c_lflag &= ~(ICANON | ECHO);
+  raw.c_cc[VMIN] = 0;
+  raw.c_cc[VTIME] = 0;
+  tcsetattr(fd, TCSANOW, &raw);
+
+  // Terminals ignore OSC sequences they don't understand, but they all
+  // answer a device attributes request. Since replies come back in order,
+  // seeing that answer means there's nothing left to wait for.
+  string query;
+  for (int n = 0; n < 256; ++n) {
+    query += "\x1b]4;" + std::to_string(n) + ";?\a";
+  }
+  query += "\x1b[c";
+  const char* data = query.data();
+  size_t size = query.size();
+  while (size) {
+    ssize_t rc = write(fd, data, size);
+    if (rc < 0 && errno == EINTR) {
+      continue;
+    }
+    if (rc <= 0) {
+      break;
+    }
+    data += rc;
+    size -= rc;
+  }
+
+  string reply;
+  auto deadline = std::chrono::steady_clock::now() +
+                  std::chrono::milliseconds(timeout_ms);
+  for (;;) {
+    size_t attributes = reply.find("\x1b[?");
+    if (attributes != string::npos &&
+        reply.find('c', attributes) != string::npos) {
+      break;
+    }
+    auto left = std::chrono::duration_cast<std::chrono::microseconds>(
+        deadline - std::chrono::steady_clock::now()).count();
+    if (left <= 0) {
+      break;
+    }
+    timeval tv = {static_cast<time_t>(left / 1000000),
+                  static_cast<suseconds_t>(left % 1000000)};
+    fd_set fds;
+    FD_ZERO(&fds);
+    FD_SET(fd, &fds);
+    int rc = select(fd + 1, &fds, nullptr, nullptr, &tv);
+    if (rc < 0 && errno == EINTR) {
+      continue;
+    }
+    if (rc <= 0) {
+      break;
+    }
+    char buf[4096];
+    ssize_t got = read(fd, buf, sizeof(buf));
+    if (got <= 0) {
+      break;
+    }
+    reply.append(buf, got);
+  }
+  tcsetattr(fd, TCSANOW, &old_mode);
+  close(fd);
+  return ParsePaletteReply(reply, colors);
+}
+
+void LoadTerminalPalette() {
+  string path = CachePath();
+  if (!FLAGS_termpalette_refresh && !path.empty()) {
+    std::ifstream in(path, std::ios::binary);
+    if (in && LoadXtermColors(in)) {
+      return;
+    }
+  }
+  Pixel colors[256];
+  std::copy(g_xterm, g_xterm + 256, colors);
+  int found = QueryTerminalPalette(colors, FLAGS_termpalette_timeout);
+  if (found == 0) {
+    LOG(WARNING) << "Terminal didn't report its palette; using xterm colors.";
+    return;
+  }
+  LOG(INFO) << "Terminal reported " << found << " palette colors.";
+  SetXtermColors(colors);
+  if (!path.empty()) {
+    SaveCache(path);
+  }
+}
+
+// For Emacs:
+// Local Variables:
+// mode:c++
+// indent-tabs-mode:nil
+// tab-width:2
+// c-basic-offset:2
+// c-file-style: nil
+// End:
+// For VIM:
+// vim:set expandtab softtabstop=2 shiftwidth=2 tabstop=2:
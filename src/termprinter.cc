@@ -27,12 +27,15 @@ const int TermPrinter::kForegroundOff = 39;
 const int TermPrinter::kBackgroundOff = 49;
 const int TermPrinter::kForeground256 = (38 << 16) | (5 << 8);
 const int TermPrinter::kBackground256 = (48 << 16) | (5 << 8);
+const int TermPrinter::kForegroundRGB = (38 << 8) | 2;
+const int TermPrinter::kBackgroundRGB = (48 << 8) | 2;
+const int TermPrinter::kTrueColor = 1 << 24;  // Flags 0xRRGGBB in fg or bg.
 const char* TermPrinter::kEscapeStart = "\x1b[";
 const char* TermPrinter::kEscapeEnd = "m";
 const char* TermPrinter::kEscapeSep = ";";
 const char* TermPrinter::kEscapeReset = "\x1b[0m";
 
-TermPrinter::TermPrinter(std::ostream& out) : out_(out) {
+TermPrinter::TermPrinter(std::ostream& out) : dirty_(false), out_(out) {
   memset(&cur_, 0, sizeof(cur_));
   memset(&new_, 0, sizeof(cur_));
 }
@@ -123,6 +126,8 @@ void TermPrinter::Flush() {
     if (new_.fg == 0) {
       PrintSep(&first);
       out_ << kForegroundOff;
+    } else if (new_.fg & kTrueColor) {
+      PrintColor(kForegroundRGB, new_.fg, &first);
     } else {
       PrintCode(new_.fg, &first);
     }
@@ -133,6 +138,8 @@ void TermPrinter::Flush() {
     if (new_.bg == 0) {
       PrintSep(&first);
       out_ << kBackgroundOff;
+    } else if (new_.bg & kTrueColor) {
+      PrintColor(kBackgroundRGB, new_.bg, &first);
     } else {
       PrintCode(new_.bg, &first);
     }
@@ -211,6 +218,22 @@ void TermPrinter::SetBackground256(int code) {
   }
 }
 
+void TermPrinter::SetForegroundRGB(int red, int green, int blue) {
+  int code = kTrueColor | (red << 16) | (green << 8) | blue;
+  if (code != new_.fg) {
+    new_.fg = code;
+    dirty_ = true;
+  }
+}
+
+void TermPrinter::SetBackgroundRGB(int red, int green, int blue) {
+  int code = kTrueColor | (red << 16) | (green << 8) | blue;
+  if (code != new_.bg) {
+    new_.bg = code;
+    dirty_ = true;
+  }
+}
+
 void TermPrinter::PrintSep(bool* first) const {
   CHECK_NOTNULL(first);
   if (*first) {
@@ -240,6 +263,15 @@ void TermPrinter::PrintCode(int code, bool* first) {
   }
 }
 
+// Unlike PrintCode(), zero components must be printed.
+void TermPrinter::PrintColor(int selector, int color, bool* first) {
+  PrintSep(first);
+  out_ << ((selector >> 8) & 0xff) << kEscapeSep << (selector & 0xff)
+       << kEscapeSep << ((color >> 16) & 0xff)
+       << kEscapeSep << ((color >> 8) & 0xff)
+       << kEscapeSep << (color & 0xff);
+}
+
 // For Emacs:
 // Local Variables:
 // mode:c++
@@ -0,0 +1,287 @@
+// hiptext - Image to Text Converter
+// By Justine Tunney
+
+#include "hiptext/termraster.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include "hiptext/font.h"
+#include "hiptext/graphic.h"
+#include "hiptext/parallel.h"
+#include "hiptext/pixel.h"
+#include "hiptext/subcell.h"
+#include "hiptext/xterm256.h"
+
+DECLARE_string(bg);
+
+namespace {
+
+// A block element as a grid of two columns by 'rows', filled where 'mask' is
+// set, in the same bit order as the subcell renderers.
+struct Block {
+  int rows;
+  int mask;
+};
+
+const std::unordered_map<wchar_t, Block>& GetBlocks() {
+  static const std::unordered_map<wchar_t, Block>* blocks = [] {
+    auto res = new std::unordered_map<wchar_t, Block>;
+    for (int mask = 1; mask < 16; ++mask) {
+      res->emplace(QuadrantGlyph(mask), Block{2, mask});
+    }
+    for (int mask = 1; mask < 64; ++mask) {
+      res->emplace(SextantGlyph(mask), Block{3, mask});
+    }
+    return res;
+  }();
+  return *blocks;
+}
+
+Pixel ResolveColor(int color, const Pixel& fallback) {
+  if (color == kDefaultColor) {
+    return fallback;
+  }
+  if (color & kRGBColor) {
+    return Pixel(color >> 16 & 255, color >> 8 & 255, color & 255);
+  }
+  return g_xterm[color & 255];
+}
+
+}  // namespace
+
+void TermGrid::Write(const std::string& text) {
+  size_t n = 0;
+  while (n < text.size()) {
+    uint8_t ch = text[n++];
+    if (ch == '\x1b' && n < text.size()) {
+      uint8_t kind = text[n++];
+      if (kind == '[') {
+        // Control sequence: numbers split by semicolons, then a final byte.
+        std::vector<int> params(1, 0);
+        while (n < text.size() && (static_cast<uint8_t>(text[n]) < 0x40 ||
+                                    static_cast<uint8_t>(text[n]) > 0x7e)) {
+          if (text[n] == ';') {
+            params.push_back(0);
+          } else if ('0' <= text[n] && text[n] <= '9') {
+            params.back() = params.back() * 10 + (text[n] - '0');
+          }
+          ++n;
+        }
+        if (n == text.size()) {
+          break;
+        }
+        switch (text[n++]) {
+          case 'm':
+            SelectGraphicRendition(params);
+            break;
+          case 'H':
+          case 'f':
+            y_ = std::max(1, params[0]) - 1;
+            x_ = params.size() > 1 ? std::max(1, params[1]) - 1 : 0;
+            break;
+        }
+      } else if (kind == 'P' || kind == '_' || kind == ']') {
+        // Control strings, like SIXEL and kitty images, end at a string
+        // terminator or, for OSC, a bell.
+        while (n < text.size()) {
+          if (text[n] == '\a' && kind == ']') {
+            ++n;
+            break;
+          }
+          if (text[n] == '\x1b' && n + 1 < text.size() && text[n + 1] == '\\') {
+            n += 2;
+            break;
+          }
+          ++n;
+        }
+      }
+      continue;
+    }
+    if (ch == '\n') {
+      x_ = 0;
+      ++y_;
+      continue;
+    }
+    if (ch == '\r') {
+      x_ = 0;
+      continue;
+    }
+    if (ch < 0x20) {
+      continue;
+    }
+    // Decode UTF-8 by hand, since the locale might not be a UTF-8 one.
+    int32_t code = ch;
+    int more = 0;
+    if (ch >= 0xf0) {
+      code = ch & 0x07;
+      more = 3;
+    } else if (ch >= 0xe0) {
+      code = ch & 0x0f;
+      more = 2;
+    } else if (ch >= 0xc0) {
+      code = ch & 0x1f;
+      more = 1;
+    } else if (ch >= 0x80) {
+      continue;
+    }
+    for (; more && n < text.size() && (text[n] & 0xc0) == 0x80; --more) {
+      code = code << 6 | (text[n++] & 0x3f);
+    }
+    if (!more) {
+      Put(static_cast<wchar_t>(code));
+    }
+  }
+}
+
+void TermGrid::SelectGraphicRendition(const std::vector<int>& params) {
+  for (size_t n = 0; n < params.size(); ++n) {
+    int code = params[n];
+    if ((code == 38 || code == 48) && n + 1 < params.size()) {
+      int color = kDefaultColor;
+      if (params[n + 1] == 5 && n + 2 < params.size()) {
+        color = params[n + 2] & 255;
+        n += 2;
+      } else if (params[n + 1] == 2 && n + 4 < params.size()) {
+        color = (kRGBColor | (params[n + 2] & 255) << 16 |
+                 (params[n + 3] & 255) << 8 | (params[n + 4] & 255));
+        n += 4;
+      } else {
+        continue;
+      }
+      (code == 38 ? fg_ : bg_) = color;
+    } else if (code == 0) {
+      fg_ = kDefaultColor;
+      bg_ = kDefaultColor;
+      flip_ = false;
+    } else if (code == 7 || code == 27) {
+      flip_ = code == 7;
+    } else if (code == 39) {
+      fg_ = kDefaultColor;
+    } else if (code == 49) {
+      bg_ = kDefaultColor;
+    } else if (30 <= code && code <= 37) {
+      fg_ = code - 30;
+    } else if (40 <= code && code <= 47) {
+      bg_ = code - 40;
+    } else if (90 <= code && code <= 97) {
+      fg_ = code - 90 + 8;
+    } else if (100 <= code && code <= 107) {
+      bg_ = code - 100 + 8;
+    }
+  }
+}
+
+void TermGrid::Put(wchar_t glyph) {
+  if (static_cast<int>(rows_.size()) <= y_) {
+    rows_.resize(y_ + 1);
+  }
+  std::vector<TermCell>& row = rows_[y_];
+  if (static_cast<int>(row.size()) <= x_) {
+    row.resize(x_ + 1);
+  }
+  TermCell& cell = row[x_++];
+  cell.glyph = glyph;
+  cell.fg = flip_ ? bg_ : fg_;
+  cell.bg = flip_ ? fg_ : bg_;
+}
+
+int TermGrid::width() const {
+  size_t res = 0;
+  for (const auto& row : rows_) {
+    res = std::max(res, row.size());
+  }
+  return res;
+}
+
+const TermCell& TermGrid::Get(int x, int y) const {
+  static const TermCell kBlank;
+  if (y < 0 || y >= height() || x < 0 ||
+      x >= static_cast<int>(rows_[y].size())) {
+    return kBlank;
+  }
+  return rows_[y][x];
+}
+
+Graphic RasterizeTerminal(const TermGrid& grid) {
+  GlyphAtlas& atlas = GetGlyphAtlas();
+  const Glyph& em = atlas.Get(L'M');
+  const int cell_width = em.width;
+  const int cell_height = em.height;
+  const Pixel default_fg = g_xterm[7];
+  const Pixel default_bg = Pixel(FLAGS_bg);
+  const auto& blocks = GetBlocks();
+
+  // The atlas can only be shared between threads once it stops changing, so
+  // render any glyphs it's missing up front.
+  for (int y = 0; y < grid.height(); ++y) {
+    for (int x = 0; x < grid.width(); ++x) {
+      wchar_t glyph = grid.Get(x, y).glyph;
+      if (!blocks.count(glyph)) {
+        atlas.Get(glyph);
+      }
+    }
+  }
+
+  Graphic res(grid.width() * cell_width, grid.height() * cell_height);
+  ParallelFor(0, grid.height(), [&](int row) {
+    for (int col = 0; col < grid.width(); ++col) {
+      const TermCell& cell = grid.Get(col, row);
+      const Pixel fg = ResolveColor(cell.fg, default_fg);
+      const Pixel bg = ResolveColor(cell.bg, default_bg);
+      const int left = col * cell_width;
+      const int top = row * cell_height;
+      auto block = blocks.find(cell.glyph);
+      if (block != blocks.end()) {
+        const int rows = block->second.rows;
+        const int mask = block->second.mask;
+        for (int y = 0; y < cell_height; ++y) {
+          for (int x = 0; x < cell_width; ++x) {
+            int bit = y * rows / cell_height * 2 + x * 2 / cell_width;
+            res.Get(left + x, top + y) = (mask >> bit & 1) ? fg : bg;
+          }
+        }
+        continue;
+      }
+      // Wider glyphs get clipped to the cell, like a terminal would.
+      const Glyph& glyph = atlas.Get(cell.glyph);
+      const uint8_t* coverage = atlas.coverage(glyph);
+      for (int y = 0; y < cell_height; ++y) {
+        for (int x = 0; x < cell_width; ++x) {
+          int level = 0;
+          if (x < glyph.width && y < glyph.height) {
+            level = coverage[y * glyph.width + x];
+          }
+          Pixel& pix = res.Get(left + x, top + y);
+          if (level == 0) {
+            pix = bg;
+          } else if (level == 255) {
+            pix = fg;
+          } else {
+            double a = level / 255.0;
+            pix = Pixel(bg.red() + (fg.red() - bg.red()) * a,
+                        bg.green() + (fg.green() - bg.green()) * a,
+                        bg.blue() + (fg.blue() - bg.blue()) * a);
+          }
+        }
+      }
+    }
+  });
+  return res;
+}
+
+// For Emacs:
+// Local Variables:
+// mode:c++
+// indent-tabs-mode:nil
+// tab-width:2
+// c-basic-offset:2
+// c-file-style: nil
+// End:
+// For VIM:
+// vim:set expandtab softtabstop=2 shiftwidth=2 tabstop=2:
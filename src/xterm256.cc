@@ -2,11 +2,18 @@
 // By Justine Tunney
 
 #include "hiptext/xterm256.h"
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <utility>
 #include <gflags/gflags.h>
 #include <glog/logging.h>
+#include "hiptext/palette.h"
 #include "hiptext/pixel.h"
 
 DEFINE_bool(fast, false, "Use O(1) xterm256 approximate color quantizer.");
+DEFINE_bool(oklab, false, "Match colors in the perceptually uniform OKLab "
+            "color space rather than by RGB distance.");
 
 static const uint8_t g_cube_steps[] = {0, 95, 135, 175, 215, 255};
 
@@ -35,8 +42,74 @@ uint8_t rgb_to_xterm(const Pixel& pix, int begin, int end) {
   return best_match;
 }
 
+namespace {
+
+// Search structures for the sixteen basic colors and for the rest.
+struct XtermPalettes {
+  XtermPalettes() = default;
+  explicit XtermPalettes(const Pixel* colors)
+      : basic{Palette(colors, colors + 16),
+              Palette(colors, colors + 16, ColorSpace::kOKLab)},
+        extended{Palette(colors + 16, colors + 256),
+                 Palette(colors + 16, colors + 256, ColorSpace::kOKLab)} {}
+  Palette basic[2];     // Indexed by FLAGS_oklab.
+  Palette extended[2];
+};
+
+std::unique_ptr<XtermPalettes> g_custom;
+
+const XtermPalettes& GetPalettes() {
+  if (g_custom) {
+    return *g_custom;
+  }
+  static const XtermPalettes defaults(g_xterm);
+  return defaults;
+}
+
+const char kMagic[] = "hiptext xterm palette 1\n";
+
+}  // namespace
+
+void SetXtermColors(const Pixel colors[256]) {
+  std::copy(colors, colors + 256, g_xterm);
+  g_custom.reset(new XtermPalettes(g_xterm));
+}
+
+void SaveXtermColors(std::ostream& out) {
+  const XtermPalettes& palettes = GetPalettes();
+  out.write(kMagic, sizeof(kMagic) - 1);
+  out.write(reinterpret_cast<const char*>(g_xterm), sizeof(g_xterm));
+  for (int n = 0; n < 2; ++n) {
+    palettes.basic[n].Save(out);
+    palettes.extended[n].Save(out);
+  }
+}
+
+bool LoadXtermColors(std::istream& in) {
+  char magic[sizeof(kMagic) - 1];
+  if (!in.read(magic, sizeof(magic)) ||
+      memcmp(magic, kMagic, sizeof(magic)) != 0) {
+    return false;
+  }
+  Pixel colors[256];
+  if (!in.read(reinterpret_cast<char*>(colors), sizeof(colors))) {
+    return false;
+  }
+  std::unique_ptr<XtermPalettes> palettes(new XtermPalettes);
+  for (int n = 0; n < 2; ++n) {
+    if (!palettes->basic[n].Load(in) || palettes->basic[n].size() != 16 ||
+        !palettes->extended[n].Load(in) ||
+        palettes->extended[n].size() != 240) {
+      return false;
+    }
+  }
+  std::copy(colors, colors + 256, g_xterm);
+  g_custom = std::move(palettes);
+  return true;
+}
+
 uint8_t rgb_to_xterm16(const Pixel& pix) {
-  return rgb_to_xterm(pix, 0, 16);
+  return GetPalettes().basic[FLAGS_oklab].Nearest(pix);
 }
 
 static int unstep(uint8_t c) {
@@ -57,7 +130,7 @@ static int unstep(uint8_t c) {
 
 uint8_t rgb_to_xterm256(const Pixel& pix) {
   if (!FLAGS_fast) {
-    return rgb_to_xterm(pix, 16, 256);
+    return 16 + GetPalettes().extended[FLAGS_oklab].Nearest(pix);
   }
   int r = static_cast<int>(pix.red()   * 255);
   int g = static_cast<int>(pix.green() * 255);
@@ -133,7 +206,7 @@ const uint8_t g_xterm_reverse[6][6][6] = {
     {226, 227, 228, 229, 230, 231} },
 };
 
-const Pixel g_xterm[256] = {
+Pixel g_xterm[256] = {
   CalculateXtermToRGB(0),
   CalculateXtermToRGB(1),
   CalculateXtermToRGB(2),
@@ -0,0 +1,115 @@
+// hiptext - Image to Text Converter
+// By Justine Tunney
+
+#include "hiptext/convolve.h"
+
+#include <algorithm>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+// Straightforward version to check the SSE one against.
+static float Reference(const Plane& src, const std::vector<float>& h,
+                       const std::vector<float>& v, int x, int y) {
+  int hr = h.size() / 2;
+  int vr = v.size() / 2;
+  float sum = 0.0f;
+  for (int j = 0; j < static_cast<int>(v.size()); ++j) {
+    int sy = std::max(0, std::min(src.height() - 1, y + j - vr));
+    for (int i = 0; i < static_cast<int>(h.size()); ++i) {
+      int sx = std::max(0, std::min(src.width() - 1, x + i - hr));
+      sum += v[j] * h[i] * src.Get(sx, sy);
+    }
+  }
+  return sum;
+}
+
+TEST(ConvolveTest, MatchesReference) {
+  // Seven wide, so both the SSE loop and its tail get used.
+  Plane src(7, 5);
+  for (int y = 0; y < 5; ++y) {
+    for (int x = 0; x < 7; ++x) {
+      src.Get(x, y) = (x * 13 + y * 7) % 10 / 10.0f;
+    }
+  }
+  std::vector<float> h = {0.25f, -1.0f, 0.5f, 2.0f, 0.75f};
+  std::vector<float> v = {1.0f, -0.5f, 3.0f};
+  Plane res = ConvolveSeparable(src, h, v);
+  ASSERT_EQ(7, res.width());
+  ASSERT_EQ(5, res.height());
+  for (int y = 0; y < 5; ++y) {
+    for (int x = 0; x < 7; ++x) {
+      EXPECT_NEAR(Reference(src, h, v, x, y), res.Get(x, y), 1e-5)
+          << x << "," << y;
+    }
+  }
+}
+
+TEST(ConvolveTest, GaussianKernel) {
+  std::vector<float> kernel = GaussianKernel(1.0);
+  ASSERT_EQ(7u, kernel.size());
+  float total = 0.0f;
+  for (float weight : kernel) {
+    total += weight;
+  }
+  EXPECT_NEAR(1.0, total, 1e-6);
+  EXPECT_GT(kernel[3], kernel[2]);
+  EXPECT_FLOAT_EQ(kernel[2], kernel[4]);
+}
+
+TEST(ConvolveTest, BlurKeepsFlatAreas) {
+  Plane src(9, 9);
+  for (int y = 0; y < 9; ++y) {
+    for (int x = 0; x < 9; ++x) {
+      src.Get(x, y) = 0.5f;
+    }
+  }
+  Plane res = GaussianBlur(src, 2.0);
+  for (int y = 0; y < 9; ++y) {
+    for (int x = 0; x < 9; ++x) {
+      EXPECT_NEAR(0.5, res.Get(x, y), 1e-5);
+    }
+  }
+}
+
+TEST(ConvolveTest, SharpenSteepensEdges) {
+  Plane src(8, 1);
+  for (int x = 4; x < 8; ++x) {
+    src.Get(x, 0) = 1.0f;
+  }
+  Plane res = Sharpen(src, 1.0, 1.0);
+  EXPECT_LT(res.Get(3, 0), 0.0f);
+  EXPECT_GT(res.Get(4, 0), 1.0f);
+  EXPECT_NEAR(0.0, res.Get(0, 0), 1e-3);
+}
+
+TEST(ConvolveTest, Sobel) {
+  // Dark on the left, bright on the right.
+  Plane src(6, 4);
+  for (int y = 0; y < 4; ++y) {
+    for (int x = 3; x < 6; ++x) {
+      src.Get(x, y) = 1.0f;
+    }
+  }
+  Plane gx(0, 0);
+  Plane gy(0, 0);
+  Sobel(src, &gx, &gy);
+  EXPECT_FLOAT_EQ(4.0f, gx.Get(2, 1));
+  EXPECT_FLOAT_EQ(4.0f, gx.Get(3, 1));
+  EXPECT_FLOAT_EQ(0.0f, gx.Get(0, 1));
+  EXPECT_FLOAT_EQ(0.0f, gx.Get(5, 1));
+  for (int x = 0; x < 6; ++x) {
+    EXPECT_FLOAT_EQ(0.0f, gy.Get(x, 2));
+  }
+}
+
+// For Emacs:
+// Local Variables:
+// mode:c++
+// indent-tabs-mode:nil
+// tab-width:2
+// c-basic-offset:2
+// c-file-style:nil
+// End:
+// For VIM:
+// vim:set expandtab softtabstop=2 shiftwidth=2 tabstop=2:
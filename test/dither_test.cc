@@ -0,0 +1,245 @@
+// hiptext - Image to Text Converter
+// By Justine Tunney
+
+#include "hiptext/dither.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+
+#include "hiptext/artiste.h"
+#include "hiptext/bluenoise.h"
+#include "hiptext/graphic.h"
+#include "hiptext/pixel.h"
+#include "hiptext/xterm256.h"
+
+DECLARE_string(dither);
+
+namespace {
+
+// Ulichney's void-and-cluster method, which made g_blue_noise. Points are
+// ranked by repeatedly taking the tightest cluster out of, or filling the
+// largest void in, a binary pattern, where tightness is measured with a
+// Gaussian that wraps around the edges so the result tiles seamlessly.
+class VoidAndCluster {
+ public:
+  explicit VoidAndCluster(int size)
+      : size_(size), pattern_(size * size), energy_(size * size) {
+    for (int dy = -kRadius; dy <= kRadius; ++dy) {
+      for (int dx = -kRadius; dx <= kRadius; ++dx) {
+        kernel_.push_back(std::exp(-(dx * dx + dy * dy) / (2 * 1.5 * 1.5)));
+      }
+    }
+  }
+
+  void Set(int index, bool on) {
+    pattern_[index] = on;
+    int x0 = index % size_;
+    int y0 = index / size_;
+    const double* w = kernel_.data();
+    for (int dy = -kRadius; dy <= kRadius; ++dy) {
+      int y = (y0 + dy + size_) % size_;
+      for (int dx = -kRadius; dx <= kRadius; ++dx, ++w) {
+        int x = (x0 + dx + size_) % size_;
+        energy_[y * size_ + x] += on ? *w : -*w;
+      }
+    }
+  }
+
+  int TightestCluster() const { return Find(true); }
+  int LargestVoid() const { return Find(false); }
+
+ private:
+  static const int kRadius = 6;
+
+  // Returns the 'on' pixel with the most energy, or the off pixel with least.
+  int Find(bool on) const {
+    int best = -1;
+    for (int n = 0; n < size_ * size_; ++n) {
+      if (pattern_[n] == on &&
+          (best < 0 || (on ? energy_[n] > energy_[best]
+                           : energy_[n] < energy_[best]))) {
+        best = n;
+      }
+    }
+    return best;
+  }
+
+  int size_;
+  std::vector<bool> pattern_;
+  std::vector<double> energy_;
+  std::vector<double> kernel_;
+};
+
+std::vector<int> MakeBlueNoise() {
+  const int size = 64;
+  const int area = size * size;
+  std::vector<int> rank(area);
+
+  // Scatter some points at random, then relax them into an even pattern.
+  VoidAndCluster initial(size);
+  std::mt19937 rng(0);
+  std::vector<int> order(area);
+  for (int n = 0; n < area; ++n) {
+    order[n] = n;
+  }
+  std::shuffle(order.begin(), order.end(), rng);
+  int ones = area / 10;
+  for (int n = 0; n < ones; ++n) {
+    initial.Set(order[n], true);
+  }
+  for (int n = 0; n < area; ++n) {
+    int cluster = initial.TightestCluster();
+    initial.Set(cluster, false);
+    int hole = initial.LargestVoid();
+    initial.Set(hole, true);
+    if (hole == cluster) {
+      break;
+    }
+  }
+
+  // Rank the initial points by removing them tightest first, then rank the
+  // rest by filling voids until the pattern is full.
+  VoidAndCluster removing = initial;
+  for (int n = ones - 1; n >= 0; --n) {
+    int cluster = removing.TightestCluster();
+    removing.Set(cluster, false);
+    rank[cluster] = n;
+  }
+  VoidAndCluster adding = initial;
+  for (int n = ones; n < area; ++n) {
+    int hole = adding.LargestVoid();
+    adding.Set(hole, true);
+    rank[hole] = n;
+  }
+  return rank;
+}
+
+}  // namespace
+
+// Returns the average grey level of the quantized image.
+static double MeanLevel(DitherMode mode, const Graphic& graphic) {
+  Ditherer ditherer(mode, PerPixel(rgb_to_xterm256), g_xterm, 16, 256);
+  std::vector<uint8_t> codes = ditherer.Quantize(graphic);
+  double total = 0.0;
+  for (uint8_t code : codes) {
+    total += g_xterm[code].red() * 255.0;
+  }
+  return total / codes.size();
+}
+
+TEST(DitherTest, PreservesAverage) {
+  // Halfway between two entries of the xterm grey ramp.
+  Graphic flat(64, 64, Pixel(13, 13, 13));
+  EXPECT_NEAR(8.0, MeanLevel(DitherMode::kNone, flat), 0.01);
+  EXPECT_NEAR(13.0, MeanLevel(DitherMode::kFloydSteinberg, flat), 0.5);
+  EXPECT_NEAR(13.0, MeanLevel(DitherMode::kSierraLite, flat), 0.5);
+  EXPECT_NEAR(13.0, MeanLevel(DitherMode::kBayer, flat), 1.0);
+  EXPECT_NEAR(13.0, MeanLevel(DitherMode::kBlueNoise, flat), 1.0);
+}
+
+TEST(DitherTest, OrderedIsAnchoredToPosition) {
+  Graphic a(70, 70, Pixel(100, 120, 140));
+  Graphic b = a;
+  for (int x = 0; x < 10; ++x) {
+    b.Get(x, 0) = Pixel(255, 0, 0);
+  }
+  for (DitherMode mode : {DitherMode::kBayer, DitherMode::kBlueNoise}) {
+    Ditherer ditherer(mode, PerPixel(rgb_to_xterm256), g_xterm, 16, 256);
+    std::vector<uint8_t> ca = ditherer.Quantize(a);
+    std::vector<uint8_t> cb = ditherer.Quantize(b);
+    for (size_t n = 10; n < ca.size(); ++n) {
+      ASSERT_EQ(ca[n], cb[n]) << n;
+    }
+  }
+}
+
+TEST(DitherTest, RowsMatchTheWholeFrame) {
+  // Wider than a row of thresholds, and not a multiple of one.
+  Graphic graphic(150, 9);
+  for (int y = 0; y < graphic.height(); ++y) {
+    for (int x = 0; x < graphic.width(); ++x) {
+      graphic.Get(x, y) = Pixel(x * 255 / 149, (x * 7 + y * 31) & 255, y * 28);
+    }
+  }
+  for (DitherMode mode : {DitherMode::kNone, DitherMode::kFloydSteinberg,
+                          DitherMode::kSierraLite, DitherMode::kBayer,
+                          DitherMode::kBlueNoise}) {
+    Ditherer ditherer(mode, PerPixel(rgb_to_xterm256), g_xterm, 16, 256);
+    std::vector<uint8_t> frame = ditherer.Quantize(graphic);
+    std::vector<uint8_t> rows(frame.size());
+    for (int y = 0; y < graphic.height(); ++y) {
+      ditherer.QuantizeRow(graphic, y, &rows[y * graphic.width()]);
+    }
+    EXPECT_EQ(frame, rows);
+  }
+}
+
+TEST(DitherTest, SpreadFollowsThePalette) {
+  // The gap between palette entries is remembered, so make sure a different
+  // palette in between doesn't get the wrong one.
+  static const Pixel kMonochrome[2] = {Pixel::kBlack, Pixel::kWhite};
+  Graphic grey(16, 16, Pixel(96, 96, 96));
+  Ditherer xterm(DitherMode::kBayer, PerPixel(rgb_to_xterm256),
+                 g_xterm, 16, 256);
+  std::vector<uint8_t> before = xterm.Quantize(grey);
+  Ditherer mono(DitherMode::kBayer,
+                PerPixel([](const Pixel& pix) -> uint8_t {
+                  return pix.grey() >= 0.5;
+                }),
+                kMonochrome, 0, 2);
+  std::vector<uint8_t> codes = mono.Quantize(grey);
+  int white = 0;
+  for (uint8_t code : codes) {
+    white += code;
+  }
+  EXPECT_NEAR(96, white, 16);  // About as bright, not all black.
+  Ditherer again(DitherMode::kBayer, PerPixel(rgb_to_xterm256),
+                 g_xterm, 16, 256);
+  EXPECT_EQ(before, again.Quantize(grey));
+}
+
+TEST(DitherTest, BlueNoiseTableIsUpToDate) {
+  std::vector<int> rank = MakeBlueNoise();
+  for (int y = 0; y < 64; ++y) {
+    for (int x = 0; x < 64; ++x) {
+      ASSERT_EQ(rank[y * 64 + x], g_blue_noise[y][x]) << x << "," << y;
+    }
+  }
+}
+
+TEST(DitherTest, VideoAvoidsErrorDiffusion) {
+  std::string saved = FLAGS_dither;
+  FLAGS_dither = "floyd";
+  EXPECT_EQ(DitherMode::kFloydSteinberg, GetDitherMode());
+  SetPlayingVideo(true);
+  EXPECT_EQ(DitherMode::kBlueNoise, GetDitherMode());
+  FLAGS_dither = "bayer";
+  EXPECT_EQ(DitherMode::kBayer, GetDitherMode());
+  SetPlayingVideo(false);
+  FLAGS_dither = saved;
+}
+
+TEST(DitherTest, ParseDitherMode) {
+  EXPECT_EQ(DitherMode::kNone, ParseDitherMode("none"));
+  EXPECT_EQ(DitherMode::kFloydSteinberg, ParseDitherMode("floyd"));
+  EXPECT_EQ(DitherMode::kSierraLite, ParseDitherMode("sierra"));
+  EXPECT_EQ(DitherMode::kBayer, ParseDitherMode("bayer"));
+  EXPECT_EQ(DitherMode::kBlueNoise, ParseDitherMode("bluenoise"));
+}
+
+// For Emacs:
+// Local Variables:
+// mode:c++
+// indent-tabs-mode:nil
+// tab-width:2
+// c-basic-offset:2
+// c-file-style:nil
+// End:
+// For VIM:
+// vim:set expandtab softtabstop=2 shiftwidth=2 tabstop=2:
@@ -0,0 +1,70 @@
+// hiptext - Image to Text Converter
+// By Justine Tunney
+
+#include "hiptext/edges.h"
+
+#include <sstream>
+#include <string>
+
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+
+#include "hiptext/graphic.h"
+#include "hiptext/pixel.h"
+
+DECLARE_string(bg);
+DECLARE_string(chars);
+
+TEST(EdgesTest, Orientation) {
+  EXPECT_EQ(2, EdgeOrientation(1.0, 0.0, 0.0));   // Brightens sideways.
+  EXPECT_EQ(0, EdgeOrientation(0.0, 1.0, 0.0));   // Brightens downwards.
+  EXPECT_EQ(1, EdgeOrientation(1.0, 1.0, -1.0));  // Toward the top right.
+  EXPECT_EQ(3, EdgeOrientation(1.0, 1.0, 1.0));   // Toward the bottom right.
+}
+
+TEST(EdgesTest, DrawsLinesAlongEdges) {
+  // Black with a white square in the middle two by two cells, away from the
+  // image border.
+  const int kCells = 6;
+  Graphic graphic(kCells * kEdgeCellWidth, kCells * kEdgeCellHeight,
+                  Pixel::kBlack);
+  for (int y = 2 * kEdgeCellHeight; y < 4 * kEdgeCellHeight; ++y) {
+    for (int x = 2 * kEdgeCellWidth; x < 4 * kEdgeCellWidth; ++x) {
+      graphic.Get(x, y) = Pixel::kWhite;
+    }
+  }
+  // The default shades start with a no-break space, which is neither one
+  // byte nor decodable without a UTF-8 locale, so use plain ASCII here.
+  std::string saved_bg = FLAGS_bg;
+  std::string saved_chars = FLAGS_chars;
+  FLAGS_bg = "black";
+  FLAGS_chars = " .:#";
+  std::ostringstream out;
+  PrintImageEdges(out, graphic);
+  FLAGS_bg = saved_bg;
+  FLAGS_chars = saved_chars;
+  std::string lines[kCells];
+  std::istringstream in(out.str());
+  for (std::string& line : lines) {
+    std::getline(in, line);
+  }
+  // The middle of the square's left side runs down a cell edge, so the cells
+  // on both sides see it.
+  EXPECT_EQ('|', lines[2][1]);
+  EXPECT_EQ('|', lines[3][4]);
+  EXPECT_EQ('-', lines[1][2]);
+  EXPECT_EQ('-', lines[4][3]);
+  // Far from the square there's nothing to draw.
+  EXPECT_EQ(' ', lines[0][0]);
+}
+
+// For Emacs:
+// Local Variables:
+// mode:c++
+// indent-tabs-mode:nil
+// tab-width:2
+// c-basic-offset:2
+// c-file-style:nil
+// End:
+// For VIM:
+// vim:set expandtab softtabstop=2 shiftwidth=2 tabstop=2:
@@ -0,0 +1,70 @@
+// hiptext - Image to Text Converter
+// By Justine Tunney
+
+#include "hiptext/font.h"
+
+#include <string>
+
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+
+#include "hiptext/graphic.h"
+#include "hiptext/pixel.h"
+
+#include "testutil.h"
+
+DECLARE_int32(font_size);
+
+TEST(GlyphAtlasTest, RendersOnce) {
+  ASSERT_TRUE(HaveFont());
+  GlyphAtlas& atlas = GetGlyphAtlas();
+  const Glyph& glyph = atlas.Get(L'@');
+  size_t bytes = atlas.bytes();
+  EXPECT_GT(glyph.width, 0);
+  EXPECT_GT(glyph.height, glyph.width);
+  EXPECT_LE(glyph.offset + glyph.width * glyph.height, bytes);
+  EXPECT_EQ(&glyph, &atlas.Get(L'@'));
+  EXPECT_EQ(&glyph, &atlas.Get(L'@', FLAGS_font_size));
+  EXPECT_EQ(bytes, atlas.bytes());
+}
+
+TEST(GlyphAtlasTest, Sizes) {
+  ASSERT_TRUE(HaveFont());
+  GlyphAtlas& atlas = GetGlyphAtlas();
+  const Glyph& small = atlas.Get(L'M', 4);
+  const Glyph& large = atlas.Get(L'M', 16);
+  EXPECT_LT(small.width, large.width);
+  EXPECT_LT(small.height, large.height);
+  EXPECT_NE(small.offset, large.offset);
+}
+
+TEST(GlyphAtlasTest, Antialiased) {
+  ASSERT_TRUE(HaveFont());
+  // Edges should be partly covered, not all or nothing.
+  Graphic letter = LoadLetter(L'O', Pixel::kWhite, Pixel::kBlack);
+  int partial = 0;
+  int full = 0;
+  for (int y = 0; y < letter.height(); ++y) {
+    for (int x = 0; x < letter.width(); ++x) {
+      double grey = letter.Get(x, y).grey();
+      if (grey > 0.0 && grey < 1.0) {
+        ++partial;
+      } else if (grey == 1.0) {
+        ++full;
+      }
+    }
+  }
+  EXPECT_GT(partial, 0);
+  EXPECT_GT(full, 0);
+}
+
+// For Emacs:
+// Local Variables:
+// mode:c++
+// indent-tabs-mode:nil
+// tab-width:2
+// c-basic-offset:2
+// c-file-style:nil
+// End:
+// For VIM:
+// vim:set expandtab softtabstop=2 shiftwidth=2 tabstop=2:
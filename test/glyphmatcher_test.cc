@@ -0,0 +1,93 @@
+// hiptext - Image to Text Converter
+// By Justine Tunney
+
+#include "hiptext/glyphmatcher.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+static const int kWidth = GlyphMatcher::kWidth;
+static const int kHeight = GlyphMatcher::kHeight;
+static const int kSize = GlyphMatcher::kSize;
+
+// Blank, a vertical bar and a horizontal bar.
+static std::vector<uint8_t> MakeBars() {
+  std::vector<uint8_t> features(3 * kSize);
+  for (int y = 0; y < kHeight; ++y) {
+    for (int x = 0; x < kWidth; ++x) {
+      features[kSize + y * kWidth + x] = (x == 1 || x == 2) ? 255 : 0;
+      features[2 * kSize + y * kWidth + x] = (y == 3 || y == 4) ? 255 : 0;
+    }
+  }
+  return features;
+}
+
+TEST(GlyphMatcherTest, MatchesShape) {
+  GlyphMatcher matcher(L" |-", MakeBars());
+  uint8_t block[kSize] = {};
+  EXPECT_EQ(L' ', matcher.glyph(matcher.Match(block)));
+  // A soft vertical line is still a bar.
+  for (int y = 0; y < kHeight; ++y) {
+    block[y * kWidth + 1] = 120;
+    block[y * kWidth + 2] = 220;
+  }
+  EXPECT_EQ(L'|', matcher.glyph(matcher.Match(block)));
+  uint8_t wide[kSize] = {};
+  for (int x = 0; x < kWidth; ++x) {
+    wide[3 * kWidth + x] = 180;
+    wide[4 * kWidth + x] = 180;
+  }
+  EXPECT_EQ(L'-', matcher.glyph(matcher.Match(wide)));
+}
+
+TEST(GlyphMatcherTest, TiesGoFirst) {
+  std::vector<uint8_t> features(2 * kSize, 7);
+  GlyphMatcher matcher(L"ab", features);
+  uint8_t block[kSize] = {};
+  EXPECT_EQ(0, matcher.Match(block));
+}
+
+TEST(GlyphMatcherTest, SumOfAbsoluteDifferences) {
+  // Random glyphs, checked against a plain loop.
+  std::mt19937 rng(3);
+  const int count = 50;
+  std::vector<uint8_t> features(count * kSize);
+  for (uint8_t& level : features) {
+    level = rng() & 255;
+  }
+  GlyphMatcher matcher(std::wstring(count, L'x'), features);
+  for (int trial = 0; trial < 100; ++trial) {
+    uint8_t block[kSize];
+    for (uint8_t& level : block) {
+      level = rng() & 255;
+    }
+    int best = 0;
+    int best_distance = 1 << 30;
+    for (int n = 0; n < count; ++n) {
+      int distance = 0;
+      for (int k = 0; k < kSize; ++k) {
+        distance += std::abs(block[k] - matcher.features(n)[k]);
+      }
+      if (distance < best_distance) {
+        best = n;
+        best_distance = distance;
+      }
+    }
+    ASSERT_EQ(best, matcher.Match(block));
+  }
+}
+
+// For Emacs:
+// Local Variables:
+// mode:c++
+// indent-tabs-mode:nil
+// tab-width:2
+// c-basic-offset:2
+// c-file-style:nil
+// End:
+// For VIM:
+// vim:set expandtab softtabstop=2 shiftwidth=2 tabstop=2:
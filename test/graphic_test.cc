@@ -0,0 +1,88 @@
+// hiptext - Image to Text Converter
+// By Justine Tunney
+
+#include "hiptext/graphic.h"
+
+#include <gtest/gtest.h>
+
+#include "hiptext/pixel.h"
+
+static void ExpectColor(const Pixel& want, const Pixel& got) {
+  EXPECT_NEAR(want.red(), got.red(), 1e-9);
+  EXPECT_NEAR(want.green(), got.green(), 1e-9);
+  EXPECT_NEAR(want.blue(), got.blue(), 1e-9);
+  EXPECT_NEAR(want.alpha(), got.alpha(), 1e-9);
+}
+
+TEST(GraphicTest, OpacifyStraightAndPremultiplied) {
+  const Pixel bg(0.0, 0.0, 1.0);
+  Graphic straight(2, 1, Pixel(1.0, 0.5, 0.0, 0.5));
+  straight.Get(1, 0) = Pixel::kClear;
+  EXPECT_FALSE(straight.opaque());
+  Graphic premultiplied = straight.Copy().Premultiply();
+  EXPECT_TRUE(premultiplied.premultiplied());
+  ExpectColor(Pixel(0.5, 0.25, 0.0, 0.5), premultiplied.Get(0, 0));
+
+  straight.Opacify(bg);
+  premultiplied.Opacify(bg);
+  for (const Graphic* graphic : {&straight, &premultiplied}) {
+    EXPECT_TRUE(graphic->opaque());
+    EXPECT_FALSE(graphic->premultiplied());
+    ExpectColor(Pixel(0.5, 0.25, 0.5), graphic->Get(0, 0));
+    ExpectColor(bg, graphic->Get(1, 0));
+  }
+}
+
+TEST(GraphicTest, OpaqueSkipsCompositing) {
+  Graphic graphic(1, 1, Pixel::kWhite);
+  EXPECT_TRUE(graphic.opaque());
+  graphic.Premultiply();
+  ExpectColor(Pixel::kWhite, graphic.Get(0, 0));
+  // A flag that lies shows that nothing was looked at.
+  graphic.Get(0, 0).set_alpha(0.0);
+  graphic.Opacify(Pixel::kBlack);
+  ExpectColor(Pixel(1.0, 1.0, 1.0, 0.0), graphic.Get(0, 0));
+}
+
+TEST(GraphicTest, UnpremultiplyRoundTrips) {
+  Graphic graphic(3, 1, Pixel(0.2, 0.4, 0.8, 0.25));
+  graphic.Get(1, 0) = Pixel::kClear;
+  graphic.Get(2, 0) = Pixel(0.3, 0.6, 0.9, 1.0);
+  Graphic res = graphic.Copy().Premultiply().Unpremultiply();
+  EXPECT_FALSE(res.premultiplied());
+  for (int x = 0; x < 3; ++x) {
+    ExpectColor(graphic.Get(x, 0), res.Get(x, 0));
+  }
+}
+
+TEST(GraphicTest, ScalingKeepsFlags) {
+  Graphic graphic(4, 4, Pixel(1.0, 0.0, 0.0, 0.5));
+  graphic.Premultiply();
+  Graphic res = graphic.BilinearScale(2, 2);
+  EXPECT_TRUE(res.premultiplied());
+  EXPECT_FALSE(res.opaque());
+  EXPECT_TRUE(Graphic(4, 4, Pixel::kBlack).BilinearScale(3, 3).opaque());
+}
+
+TEST(GraphicTest, Overlay) {
+  Graphic graphic(3, 2, Pixel::kBlack);
+  Graphic top(2, 2, Pixel(1.0, 1.0, 1.0, 0.25));
+  graphic.Overlay(top, 2, 1);
+  ExpectColor(Pixel::kBlack, graphic.Get(1, 1));
+  ExpectColor(Pixel::kBlack, graphic.Get(2, 0));
+  ExpectColor(Pixel(0.25, 0.25, 0.25), graphic.Get(2, 1));
+  graphic.Overlay(Graphic(1, 1, Pixel::kWhite), 0, 0);
+  ExpectColor(Pixel::kWhite, graphic.Get(0, 0));
+  EXPECT_TRUE(graphic.opaque());
+}
+
+// For Emacs:
+// Local Variables:
+// mode:c++
+// indent-tabs-mode:nil
+// tab-width:2
+// c-basic-offset:2
+// c-file-style:nil
+// End:
+// For VIM:
+// vim:set expandtab softtabstop=2 shiftwidth=2 tabstop=2:
@@ -0,0 +1,152 @@
+// hiptext - Image to Text Converter
+// By Justine Tunney
+
+#include "hiptext/jpeg.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+#include <jpeglib.h>
+
+#include "hiptext/graphic.h"
+#include "hiptext/pixel.h"
+
+DECLARE_int32(threads);
+
+static std::string Encode(int width, int height, int restart_rows,
+                          bool subsample) {
+  jpeg_compress_struct cinfo;
+  jpeg_error_mgr jerr;
+  cinfo.err = jpeg_std_error(&jerr);
+  jpeg_create_compress(&cinfo);
+  unsigned char* buffer = nullptr;
+  unsigned long size = 0;
+  jpeg_mem_dest(&cinfo, &buffer, &size);
+  cinfo.image_width = width;
+  cinfo.image_height = height;
+  cinfo.input_components = 3;
+  cinfo.in_color_space = JCS_RGB;
+  jpeg_set_defaults(&cinfo);
+  cinfo.restart_in_rows = restart_rows;
+  if (!subsample) {
+    cinfo.comp_info[0].h_samp_factor = 1;
+    cinfo.comp_info[0].v_samp_factor = 1;
+  }
+  jpeg_start_compress(&cinfo, TRUE);
+  std::vector<unsigned char> row(width * 3);
+  while (cinfo.next_scanline < cinfo.image_height) {
+    int y = cinfo.next_scanline;
+    for (int x = 0; x < width; ++x) {
+      row[x * 3 + 0] = (x * 7 + y) & 0xff;
+      row[x * 3 + 1] = (x ^ y) & 0xff;
+      row[x * 3 + 2] = (y * 3) & 0xff;
+    }
+    JSAMPROW rows[1] = { row.data() };
+    jpeg_write_scanlines(&cinfo, rows, 1);
+  }
+  jpeg_finish_compress(&cinfo);
+  jpeg_destroy_compress(&cinfo);
+  std::string res(reinterpret_cast<char*>(buffer), size);
+  free(buffer);
+  return res;
+}
+
+static void ExpectSameDecode(const std::string& jpeg) {
+  FLAGS_threads = 1;
+  Graphic serial = DecodeJPEG(jpeg);
+  FLAGS_threads = 4;
+  Graphic parallel = DecodeJPEG(jpeg);
+  FLAGS_threads = 0;
+  ASSERT_EQ(serial.width(), parallel.width());
+  ASSERT_EQ(serial.height(), parallel.height());
+  for (int y = 0; y < serial.height(); ++y) {
+    for (int x = 0; x < serial.width(); ++x) {
+      ASSERT_EQ(serial.Get(x, y), parallel.Get(x, y)) << x << "," << y;
+    }
+  }
+}
+
+TEST(JpegTest, ParallelMatchesSerial) {
+  ExpectSameDecode(Encode(1024, 1030, 1, false));
+  ExpectSameDecode(Encode(1024, 1030, 1, true));
+}
+
+TEST(JpegTest, ParallelMatchesSerialWithIntervalsSpanningRows) {
+  ExpectSameDecode(Encode(1100, 1000, 3, false));
+}
+
+TEST(JpegTest, NoRestartMarkers) {
+  ExpectSameDecode(Encode(1024, 1024, 0, false));
+}
+
+// Four flat quadrants of red, green, blue and white, written as CMYK the
+// way Photoshop does it, inverted with an Adobe marker.
+static std::string EncodeCMYK(J_COLOR_SPACE color_space) {
+  const int kSize = 64;
+  static const unsigned char kQuadrants[4][4] = {
+      {255, 0, 0, 255}, {0, 255, 0, 255}, {0, 0, 255, 255},
+      {255, 255, 255, 255}};
+  jpeg_compress_struct cinfo;
+  jpeg_error_mgr jerr;
+  cinfo.err = jpeg_std_error(&jerr);
+  jpeg_create_compress(&cinfo);
+  unsigned char* buffer = nullptr;
+  unsigned long size = 0;
+  jpeg_mem_dest(&cinfo, &buffer, &size);
+  cinfo.image_width = kSize;
+  cinfo.image_height = kSize;
+  cinfo.input_components = 4;
+  cinfo.in_color_space = JCS_CMYK;
+  jpeg_set_defaults(&cinfo);
+  jpeg_set_colorspace(&cinfo, color_space);
+  jpeg_set_quality(&cinfo, 100, TRUE);
+  jpeg_start_compress(&cinfo, TRUE);
+  std::vector<unsigned char> row(kSize * 4);
+  while (cinfo.next_scanline < cinfo.image_height) {
+    int y = cinfo.next_scanline;
+    for (int x = 0; x < kSize; ++x) {
+      const unsigned char* cmyk =
+          kQuadrants[(y >= kSize / 2) * 2 + (x >= kSize / 2)];
+      std::copy(cmyk, cmyk + 4, &row[x * 4]);
+    }
+    JSAMPROW rows[1] = { row.data() };
+    jpeg_write_scanlines(&cinfo, rows, 1);
+  }
+  jpeg_finish_compress(&cinfo);
+  jpeg_destroy_compress(&cinfo);
+  std::string res(reinterpret_cast<char*>(buffer), size);
+  free(buffer);
+  return res;
+}
+
+TEST(JpegTest, CMYK) {
+  for (J_COLOR_SPACE color_space : {JCS_CMYK, JCS_YCCK}) {
+    Graphic graphic = DecodeJPEG(EncodeCMYK(color_space));
+    ASSERT_EQ(64, graphic.width());
+    ASSERT_EQ(64, graphic.height());
+    const Pixel kExpected[4] = {Pixel(255, 0, 0), Pixel(0, 255, 0),
+                                Pixel(0, 0, 255), Pixel::kWhite};
+    for (int n = 0; n < 4; ++n) {
+      const Pixel& pix = graphic.Get(n % 2 * 32 + 16, n / 2 * 32 + 16);
+      EXPECT_NEAR(kExpected[n].red(), pix.red(), 0.02) << n;
+      EXPECT_NEAR(kExpected[n].green(), pix.green(), 0.02) << n;
+      EXPECT_NEAR(kExpected[n].blue(), pix.blue(), 0.02) << n;
+    }
+  }
+}
+
+// For Emacs:
+// Local Variables:
+// mode:c++
+// indent-tabs-mode:nil
+// tab-width:2
+// c-basic-offset:2
+// c-file-style:nil
+// End:
+// For VIM:
+// vim:set expandtab softtabstop=2 shiftwidth=2 tabstop=2:
@@ -0,0 +1,276 @@
+// hiptext - Image to Text Converter
+// By Justine Tunney
+
+#include "hiptext/kittyrenderer.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+
+#include "hiptext/artiste.h"
+#include "hiptext/graphic.h"
+#include "hiptext/pixel.h"
+#include "hiptext/replaycache.h"
+
+DECLARE_string(kitty_transfer);
+
+struct Command {
+  std::string control;
+  std::string payload;
+};
+
+// Splits terminal output into its graphics commands.
+static std::vector<Command> Parse(const std::string& output) {
+  std::vector<Command> res;
+  size_t pos = 0;
+  while ((pos = output.find("\x1b_G", pos)) != std::string::npos) {
+    size_t end = output.find("\x1b\\", pos);
+    EXPECT_NE(std::string::npos, end);
+    std::string body = output.substr(pos + 3, end - pos - 3);
+    size_t semi = body.find(';');
+    if (semi == std::string::npos) {
+      res.push_back({body, ""});
+    } else {
+      res.push_back({body.substr(0, semi), body.substr(semi + 1)});
+    }
+    pos = end + 2;
+  }
+  return res;
+}
+
+// Returns the value of 'key' in a command's control data, if it's there.
+static std::string Key(const std::string& control, const std::string& key) {
+  std::istringstream fields(control);
+  std::string field;
+  while (std::getline(fields, field, ',')) {
+    if (field.compare(0, key.size() + 1, key + "=") == 0) {
+      return field.substr(key.size() + 1);
+    }
+  }
+  return "";
+}
+
+// Keeps track of which images a terminal holds and which are on the screen.
+struct Terminal {
+  std::set<std::string> images;
+  std::set<std::string> placed;
+
+  void Run(const std::string& output) {
+    for (const Command& command : Parse(output)) {
+      std::string action = Key(command.control, "a");
+      std::string id = Key(command.control, "i");
+      if (action == "T") {
+        images.insert(id);
+        placed.insert(id);
+      } else if (action == "p") {
+        EXPECT_EQ(1u, images.count(id)) << "image " << id << " is gone";
+        placed.insert(id);
+      } else if (action == "d") {
+        placed.erase(id);
+        if (Key(command.control, "d") == "I") {
+          images.erase(id);
+        }
+      }
+    }
+  }
+};
+
+static std::string Unbase64(const std::string& data) {
+  static const std::string kAlphabet =
+      "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  std::string res;
+  uint32_t bits = 0;
+  int count = 0;
+  for (char c : data) {
+    if (c == '=') break;
+    bits = bits << 6 | kAlphabet.find(c);
+    count += 6;
+    if (count >= 8) {
+      count -= 8;
+      res += static_cast<char>(bits >> count & 255);
+    }
+  }
+  return res;
+}
+
+static Graphic MakeImage(int width, int height, int seed) {
+  Graphic graphic(width, height);
+  for (int y = 0; y < height; ++y) {
+    for (int x = 0; x < width; ++x) {
+      graphic.Get(x, y) = Pixel((x * 7 + seed) & 255, (y * 3) & 255,
+                                (x ^ y) & 255, 255 - seed);
+    }
+  }
+  return graphic;
+}
+
+static std::string ToBytes(const Graphic& graphic) {
+  std::string res;
+  for (int y = 0; y < graphic.height(); ++y) {
+    for (int x = 0; x < graphic.width(); ++x) {
+      const Pixel& pix = graphic.Get(x, y);
+      res += static_cast<char>(pix.red() * 255 + 0.5);
+      res += static_cast<char>(pix.green() * 255 + 0.5);
+      res += static_cast<char>(pix.blue() * 255 + 0.5);
+      res += static_cast<char>(pix.alpha() * 255 + 0.5);
+    }
+  }
+  return res;
+}
+
+static std::string Render(KittyRenderer* renderer, const Graphic& graphic) {
+  std::ostringstream os;
+  (*renderer)(os, graphic);
+  return os.str();
+}
+
+TEST(KittyRendererTest, DirectIsChunked) {
+  FLAGS_kitty_transfer = "direct";
+  Graphic graphic = MakeImage(40, 30, 1);
+  KittyRenderer renderer;
+  std::vector<Command> commands = Parse(Render(&renderer, graphic));
+  ASSERT_EQ(2u, commands.size());
+  EXPECT_EQ(0u, commands[0].control.find("a=T,f=32,s=40,v=30,q=2"));
+  EXPECT_NE(std::string::npos, commands[0].control.find(",m=1"));
+  EXPECT_EQ("q=2,m=0", commands[1].control);
+  EXPECT_EQ(4096u, commands[0].payload.size());
+  EXPECT_EQ(ToBytes(graphic),
+            Unbase64(commands[0].payload + commands[1].payload));
+  EXPECT_TRUE(KittyOutputIsReplayable());
+  FLAGS_kitty_transfer = "auto";
+}
+
+TEST(KittyRendererTest, TempFile) {
+  FLAGS_kitty_transfer = "file";
+  Graphic graphic = MakeImage(5, 3, 2);
+  KittyRenderer renderer;
+  std::vector<Command> commands = Parse(Render(&renderer, graphic));
+  ASSERT_EQ(1u, commands.size());
+  EXPECT_NE(std::string::npos, commands[0].control.find(",t=t"));
+  std::string path = Unbase64(commands[0].payload);
+  EXPECT_NE(std::string::npos, path.find("tty-graphics-protocol"));
+  std::ifstream file(path, std::ios::binary);
+  std::string data((std::istreambuf_iterator<char>(file)),
+                   std::istreambuf_iterator<char>());
+  EXPECT_EQ(ToBytes(graphic), data);
+  unlink(path.c_str());
+  EXPECT_FALSE(KittyOutputIsReplayable());
+  FLAGS_kitty_transfer = "auto";
+}
+
+TEST(KittyRendererTest, SharedMemory) {
+  FLAGS_kitty_transfer = "shm";
+  Graphic graphic = MakeImage(5, 3, 3);
+  KittyRenderer renderer;
+  std::vector<Command> commands = Parse(Render(&renderer, graphic));
+  ASSERT_EQ(1u, commands.size());
+  if (commands[0].control.find(",t=s") == std::string::npos) {
+    FLAGS_kitty_transfer = "auto";
+    return;  // No shared memory here, so it fell back to something else.
+  }
+  std::string name = Unbase64(commands[0].payload);
+  int fd = shm_open(name.c_str(), O_RDONLY, 0);
+  ASSERT_GE(fd, 0);
+  std::string data(5 * 3 * 4, '\0');
+  EXPECT_EQ(static_cast<ssize_t>(data.size()),
+            read(fd, &data[0], data.size()));
+  close(fd);
+  shm_unlink(name.c_str());
+  EXPECT_EQ(ToBytes(graphic), data);
+  FLAGS_kitty_transfer = "auto";
+}
+
+TEST(KittyRendererTest, VideoReusesImages) {
+  FLAGS_kitty_transfer = "direct";
+  SetPlayingVideo(true);
+  Graphic a = MakeImage(8, 8, 4);
+  Graphic b = MakeImage(8, 8, 5);
+  KittyRenderer renderer;
+
+  std::vector<Command> first = Parse(Render(&renderer, a));
+  ASSERT_EQ(1u, first.size());
+  size_t key = first[0].control.find(",i=");
+  ASSERT_NE(std::string::npos, key);
+  std::string id = first[0].control.substr(key + 3);
+  id = id.substr(0, id.find(','));
+
+  // An unchanged frame costs nothing.
+  EXPECT_EQ("", Render(&renderer, a));
+
+  // A new one is sent, and then the old one taken down.
+  std::vector<Command> second = Parse(Render(&renderer, b));
+  ASSERT_EQ(2u, second.size());
+  EXPECT_EQ(0u, second[0].control.find("a=T"));
+  EXPECT_EQ("a=d,d=i,i=" + id + ",p=1,q=2", second[1].control);
+
+  // Going back just places the first image again.
+  std::vector<Command> third = Parse(Render(&renderer, a));
+  ASSERT_EQ(2u, third.size());
+  EXPECT_EQ("a=p,i=" + id + ",p=1,C=1,q=2", third[0].control);
+  EXPECT_EQ("", third[0].payload);
+
+  SetPlayingVideo(false);
+  FLAGS_kitty_transfer = "auto";
+}
+
+TEST(KittyRendererTest, ReplayedLoopsShowOneFrame) {
+  FLAGS_kitty_transfer = "direct";
+  SetPlayingVideo(true);
+  // More frames than the terminal is asked to keep, so some get evicted.
+  std::vector<Graphic> frames;
+  for (int n = 0; n < 20; ++n) {
+    frames.push_back(MakeImage(4, 4, n));
+  }
+  KittyRenderer renderer;
+  ReplayCache replay(1 << 20);
+  Terminal terminal;
+  // Each frame starts by homing the cursor, like Artiste::PrintFrame().
+  const std::string kHome = "\x1b[H";
+  for (const Graphic& frame : frames) {
+    std::string bytes = kHome + Render(&renderer, frame);
+    terminal.Run(bytes);
+    replay.Record(bytes, 0);
+  }
+  replay.Finish(kHome + Render(&renderer, frames[0]));
+  ASSERT_TRUE(replay.ok());
+
+  volatile bool stop = false;
+  for (int loop = 0; loop < 2; ++loop) {
+    std::ostringstream out;
+    replay.Play(out, &stop);
+    std::string output = out.str();
+    for (size_t pos = 0; pos < output.size();) {
+      size_t end = output.find(kHome, pos + 1);
+      terminal.Run(output.substr(pos, end - pos));
+      EXPECT_EQ(1u, terminal.placed.size()) << "loop " << loop;
+      pos = end;
+    }
+  }
+
+  SetPlayingVideo(false);
+  FLAGS_kitty_transfer = "auto";
+}
+
+// For Emacs:
+// Local Variables:
+// mode:c++
+// indent-tabs-mode:nil
+// tab-width:2
+// c-basic-offset:2
+// c-file-style:nil
+// End:
+// For VIM:
+// vim:set expandtab softtabstop=2 shiftwidth=2 tabstop=2:
@@ -0,0 +1,57 @@
+// hiptext - Image to Text Converter
+// By Justine Tunney
+
+#include "hiptext/macterm.h"
+
+#include <cmath>
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include "hiptext/artiste.h"
+#include "hiptext/pixel.h"
+
+// Rounds each channel to six bits, which is what the video cache keys on.
+static Pixel Snap(const Pixel& pix) {
+  auto level = [](double v) {
+    return static_cast<int>(std::lround(v * 63.0)) * 255 / 63;
+  };
+  return Pixel(level(pix.red()), level(pix.green()), level(pix.blue()));
+}
+
+static void ExpectSame(const MactermColor& want, const MactermColor& got) {
+  EXPECT_EQ(want.fg(), got.fg());
+  EXPECT_EQ(want.bg(), got.bg());
+  EXPECT_EQ(want.symbol(), got.symbol());
+}
+
+TEST(MactermColorTest, VideoCacheMatchesComputing) {
+  std::mt19937 rng(1);
+  std::uniform_int_distribution<int> channel(0, 255);
+  auto random = [&]() {
+    return Pixel(channel(rng), channel(rng), channel(rng));
+  };
+  for (int n = 0; n < 200; ++n) {
+    Pixel top = random();
+    Pixel bot = random();
+    SetPlayingVideo(false);
+    MactermColor still(Snap(top), Snap(bot));
+    SetPlayingVideo(true);
+    MactermColor miss(top, bot);
+    MactermColor hit(top, bot);
+    SetPlayingVideo(false);
+    ExpectSame(still, miss);
+    ExpectSame(still, hit);
+  }
+}
+
+// For Emacs:
+// Local Variables:
+// mode:c++
+// indent-tabs-mode:nil
+// tab-width:2
+// c-basic-offset:2
+// c-file-style:nil
+// End:
+// For VIM:
+// vim:set expandtab softtabstop=2 shiftwidth=2 tabstop=2:
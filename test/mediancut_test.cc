@@ -0,0 +1,65 @@
+// hiptext - Image to Text Converter
+// By Justine Tunney
+
+#include "hiptext/mediancut.h"
+
+#include <gtest/gtest.h>
+
+#include "hiptext/graphic.h"
+#include "hiptext/pixel.h"
+
+TEST(MedianCutTest, FewColorsAreExact) {
+  const Pixel kColors[] = {
+    {255, 0, 0}, {0, 255, 0}, {0, 0, 255}, {255, 255, 255},
+  };
+  Graphic graphic(40, 40);
+  for (int y = 0; y < 40; ++y) {
+    for (int x = 0; x < 40; ++x) {
+      graphic.Get(x, y) = kColors[(x / 10 + y / 10) % 4];
+    }
+  }
+  AdaptivePalette palette(graphic, Pixel::kBlack, 16);
+  EXPECT_EQ(4u, palette.colors().size());
+  for (const Pixel& color : kColors) {
+    EXPECT_EQ(color, palette.colors()[palette.Map(color)]);
+  }
+}
+
+TEST(MedianCutTest, Gradient) {
+  Graphic graphic(512, 512);
+  for (int y = 0; y < 512; ++y) {
+    for (int x = 0; x < 512; ++x) {
+      graphic.Get(x, y) = Pixel(x / 2, y / 2, 128);
+    }
+  }
+  AdaptivePalette palette(graphic, Pixel::kBlack, 256);
+  EXPECT_EQ(256u, palette.colors().size());
+  double total = 0.0;
+  for (int y = 0; y < 512; y += 3) {
+    for (int x = 0; x < 512; x += 3) {
+      const Pixel& pix = graphic.Get(x, y);
+      total += pix.Distance(palette.colors()[palette.Map(pix)]);
+    }
+  }
+  // An even 16x16 grid over the two varying channels would be off by about
+  // 6/255 on average, which is the best 256 colors can do here.
+  EXPECT_LT(total / (171 * 171), 6.5 / 255.0);
+}
+
+TEST(MedianCutTest, TransparentUsesBackground) {
+  Graphic graphic(8, 8, Pixel::kClear);
+  AdaptivePalette palette(graphic, Pixel(0, 0, 255), 256);
+  ASSERT_EQ(1u, palette.colors().size());
+  EXPECT_EQ(Pixel(0, 0, 255), palette.colors()[0]);
+}
+
+// For Emacs:
+// Local Variables:
+// mode:c++
+// indent-tabs-mode:nil
+// tab-width:2
+// c-basic-offset:2
+// c-file-style:nil
+// End:
+// For VIM:
+// vim:set expandtab softtabstop=2 shiftwidth=2 tabstop=2:
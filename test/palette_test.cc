@@ -0,0 +1,149 @@
+// hiptext - Image to Text Converter
+// By Justine Tunney
+
+#include "hiptext/palette.h"
+
+#include <array>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "hiptext/pixel.h"
+#include "hiptext/xterm256.h"
+
+static int BruteForce(const std::vector<Pixel>& colors, const Pixel& pix) {
+  int best = 0;
+  double best_dist = 1e9;
+  for (int n = 0; n < static_cast<int>(colors.size()); ++n) {
+    double dr = pix.red() - colors[n].red();
+    double dg = pix.green() - colors[n].green();
+    double db = pix.blue() - colors[n].blue();
+    double dist = dr * dr + dg * dg + db * db;
+    if (dist < best_dist) {
+      best_dist = dist;
+      best = n;
+    }
+  }
+  return best;
+}
+
+static Pixel RandomPixel(std::mt19937* rng) {
+  std::uniform_int_distribution<int> byte(0, 255);
+  return Pixel(byte(*rng), byte(*rng), byte(*rng));
+}
+
+TEST(PaletteTest, MatchesBruteForce) {
+  std::mt19937 rng(1337);
+  for (int size : {1, 2, 7, 16, 100, 256}) {
+    std::vector<Pixel> colors;
+    for (int n = 0; n < size; ++n) {
+      colors.push_back(RandomPixel(&rng));
+    }
+    Palette palette(colors);
+    for (int n = 0; n < 5000; ++n) {
+      Pixel pix = RandomPixel(&rng);
+      ASSERT_EQ(BruteForce(colors, pix), palette.Nearest(pix)) << pix;
+    }
+  }
+}
+
+TEST(PaletteTest, TiesGoToLowestIndex) {
+  std::vector<Pixel> colors = {
+    {10, 10, 10}, {200, 0, 0}, {10, 10, 10}, {0, 0, 200}, {200, 0, 0},
+  };
+  Palette palette(colors);
+  EXPECT_EQ(0, palette.Nearest(Pixel(10, 10, 10)));
+  EXPECT_EQ(1, palette.Nearest(Pixel(250, 0, 0)));
+  EXPECT_EQ(0, palette.Nearest(Pixel(105, 5, 5)));  // Equidistant.
+}
+
+TEST(PaletteTest, Distance) {
+  std::vector<Pixel> colors = {{0, 0, 0}, {255, 255, 255}};
+  Palette palette(colors);
+  double dist;
+  EXPECT_EQ(1, palette.Nearest(Pixel(255, 255, 0), &dist));
+  EXPECT_DOUBLE_EQ(Pixel(255, 255, 0).Distance(colors[1]), dist);
+}
+
+TEST(PaletteTest, OKLab) {
+  double lab[3];
+  RGBToOKLab(Pixel(255, 255, 255), lab);
+  EXPECT_NEAR(1.0, lab[0], 1e-4);
+  EXPECT_NEAR(0.0, lab[1], 1e-4);
+  EXPECT_NEAR(0.0, lab[2], 1e-4);
+  RGBToOKLab(Pixel(255, 0, 0), lab);
+  EXPECT_NEAR(0.6279, lab[0], 1e-4);
+  EXPECT_NEAR(0.2249, lab[1], 1e-4);
+  EXPECT_NEAR(0.1258, lab[2], 1e-4);
+
+  // Check the fast cube roots against the formula done the slow way.
+  for (int n = 0; n < 4096; ++n) {
+    Pixel pix((n & 15) * 17, (n >> 4 & 15) * 17, (n >> 8) * 17);
+    double rgb[3] = {pix.red(), pix.green(), pix.blue()};
+    for (double& c : rgb) {
+      c = (c <= 0.04045) ? c / 12.92 : std::pow((c + 0.055) / 1.055, 2.4);
+    }
+    double l = std::cbrt(
+        0.4122214708 * rgb[0] + 0.5363325363 * rgb[1] + 0.0514459929 * rgb[2]);
+    double m = std::cbrt(
+        0.2119034982 * rgb[0] + 0.6806995451 * rgb[1] + 0.1073969566 * rgb[2]);
+    double s = std::cbrt(
+        0.0883024619 * rgb[0] + 0.2817188376 * rgb[1] + 0.6299787005 * rgb[2]);
+    RGBToOKLab(pix, lab);
+    EXPECT_NEAR(0.2104542553 * l + 0.7936177850 * m - 0.0040720468 * s,
+                lab[0], 1e-12);
+    EXPECT_NEAR(1.9779984951 * l - 2.4285922050 * m + 0.4505937099 * s,
+                lab[1], 1e-12);
+    EXPECT_NEAR(0.0259040371 * l + 0.7827717662 * m - 0.8086757660 * s,
+                lab[2], 1e-12);
+  }
+
+  std::mt19937 rng(7);
+  std::vector<Pixel> colors;
+  std::vector<std::array<double, 3>> labs;
+  for (int n = 0; n < 64; ++n) {
+    colors.push_back(RandomPixel(&rng));
+    labs.push_back({});
+    RGBToOKLab(colors.back(), labs.back().data());
+  }
+  Palette palette(colors, ColorSpace::kOKLab);
+  for (int n = 0; n < 5000; ++n) {
+    Pixel pix = RandomPixel(&rng);
+    RGBToOKLab(pix, lab);
+    int best = 0;
+    double best_dist = 1e9;
+    for (int c = 0; c < 64; ++c) {
+      double dist = 0.0;
+      for (int k = 0; k < 3; ++k) {
+        dist += (lab[k] - labs[c][k]) * (lab[k] - labs[c][k]);
+      }
+      if (dist < best_dist) {
+        best_dist = dist;
+        best = c;
+      }
+    }
+    ASSERT_EQ(best, palette.Nearest(pix)) << pix;
+  }
+}
+
+TEST(PaletteTest, Xterm) {
+  std::mt19937 rng(42);
+  for (int n = 0; n < 5000; ++n) {
+    Pixel pix = RandomPixel(&rng);
+    EXPECT_EQ(rgb_to_xterm(pix, 0, 16), rgb_to_xterm16(pix)) << pix;
+    EXPECT_EQ(rgb_to_xterm(pix, 16, 256), rgb_to_xterm256(pix)) << pix;
+  }
+}
+
+// For Emacs:
+// Local Variables:
+// mode:c++
+// indent-tabs-mode:nil
+// tab-width:2
+// c-basic-offset:2
+// c-file-style:nil
+// End:
+// For VIM:
+// vim:set expandtab softtabstop=2 shiftwidth=2 tabstop=2:
@@ -8,6 +8,14 @@ TEST(PixelTest, Basic) {
   EXPECT_TRUE(true);
 }
 
+TEST(PixelTest, ToByte) {
+  EXPECT_EQ(0, ToByte(-0.5));
+  EXPECT_EQ(0, ToByte(0.001));
+  EXPECT_EQ(128, ToByte(0.5));
+  EXPECT_EQ(255, ToByte(0.999));
+  EXPECT_EQ(255, ToByte(2.0));
+}
+
 // For Emacs:
 // Local Variables:
 // mode:c++
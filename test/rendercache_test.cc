@@ -0,0 +1,151 @@
+// hiptext - Image to Text Converter
+// By Justine Tunney
+
+#include "hiptext/rendercache.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utime.h>
+
+#include <gtest/gtest.h>
+
+static const char kKeyA[] = "000000000000000a";
+static const char kKeyB[] = "000000000000000b";
+static const char kKeyC[] = "000000000000000c";
+
+class RenderCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    char dir[] = "/tmp/rendercache_test.XXXXXX";
+    ASSERT_NE(nullptr, mkdtemp(dir));
+    dir_ = dir;
+  }
+
+  void TearDown() override {
+    for (const char* name : {kKeyA, kKeyB, kKeyC, "input"}) {
+      unlink(Path(name).c_str());
+    }
+    unlink(Path(std::string(kKeyA) + ".tmp1").c_str());
+    rmdir(dir_.c_str());
+  }
+
+  std::string Path(const std::string& name) const {
+    return dir_ + "/" + name;
+  }
+
+  bool Exists(const std::string& name) const {
+    return access(Path(name).c_str(), F_OK) == 0;
+  }
+
+  void Write(const std::string& name, const std::string& data) const {
+    std::ofstream(Path(name), std::ios::binary) << data;
+  }
+
+  // Sets the modification time of 'name' to 'age' seconds ago.
+  void Age(const std::string& name, int age) const {
+    utimbuf times;
+    times.actime = times.modtime = time(nullptr) - age;
+    ASSERT_EQ(0, utime(Path(name).c_str(), &times));
+  }
+
+  // What Replay() writes, or "miss".
+  std::string Replay(const RenderCache& cache, const std::string& key) const {
+    FILE* fp = tmpfile();
+    std::string res = "miss";
+    if (cache.Replay(key, fileno(fp))) {
+      res.clear();
+      rewind(fp);
+      int ch;
+      while ((ch = fgetc(fp)) != EOF) {
+        res += static_cast<char>(ch);
+      }
+    }
+    fclose(fp);
+    return res;
+  }
+
+  std::string dir_;
+};
+
+TEST_F(RenderCacheTest, KeyDependsOnFileAndSalt) {
+  RenderCache cache(dir_, 1 << 20);
+  EXPECT_EQ("", cache.Key(Path("input"), "80x24"));
+  Write("input", "pixels");
+  std::string key = cache.Key(Path("input"), "80x24");
+  EXPECT_EQ(16u, key.size());
+  EXPECT_EQ(key, cache.Key(Path("input"), "80x24"));
+  EXPECT_NE(key, cache.Key(Path("input"), "100x24"));
+  Write("input", "more pixels");
+  EXPECT_NE(key, cache.Key(Path("input"), "80x24"));
+}
+
+TEST_F(RenderCacheTest, HitAndMiss) {
+  RenderCache cache(dir_, 1 << 20);
+  EXPECT_EQ("miss", Replay(cache, kKeyA));
+  cache.Store(kKeyA, "hello");
+  EXPECT_EQ("hello", Replay(cache, kKeyA));
+  EXPECT_EQ("miss", Replay(cache, kKeyB));
+}
+
+TEST_F(RenderCacheTest, ReplayFailsIfWriteFails) {
+  RenderCache cache(dir_, 1 << 20);
+  cache.Store(kKeyA, "hello");
+  int fd = open("/dev/null", O_RDONLY);
+  ASSERT_LE(0, fd);
+  EXPECT_FALSE(cache.Replay(kKeyA, fd));
+  close(fd);
+}
+
+TEST_F(RenderCacheTest, ReplayCutShortIsStillAHit) {
+  RenderCache cache(dir_, 1 << 20);
+  cache.Store(kKeyA, std::string(1 << 18, 'x'));  // More than a pipe holds.
+  int fds[2];
+  ASSERT_EQ(0, pipe(fds));
+  fcntl(fds[1], F_SETFL, O_NONBLOCK);
+  EXPECT_TRUE(cache.Replay(kKeyA, fds[1]));
+  close(fds[0]);
+  close(fds[1]);
+}
+
+TEST_F(RenderCacheTest, EvictsLeastRecentlyUsed) {
+  RenderCache cache(dir_, 10);
+  cache.Store(kKeyA, "aaaa");
+  cache.Store(kKeyB, "bbbb");
+  Age(kKeyA, 2000);
+  Age(kKeyB, 1000);
+  EXPECT_EQ("aaaa", Replay(cache, kKeyA));  // Now B is the oldest.
+  cache.Store(kKeyC, "cccc");
+  EXPECT_TRUE(Exists(kKeyA));
+  EXPECT_FALSE(Exists(kKeyB));
+  EXPECT_TRUE(Exists(kKeyC));
+}
+
+TEST_F(RenderCacheTest, TempFilesCountUntilStale) {
+  const std::string temp = std::string(kKeyA) + ".tmp1";
+  RenderCache cache(dir_, 10);
+  Write(temp, "12345678");
+  cache.Store(kKeyB, "bbbb");
+  EXPECT_TRUE(Exists(temp));
+  EXPECT_FALSE(Exists(kKeyB));
+  Age(temp, 3600);
+  cache.Store(kKeyC, "cccc");
+  EXPECT_FALSE(Exists(temp));
+  EXPECT_TRUE(Exists(kKeyC));
+}
+
+// For Emacs:
+// Local Variables:
+// mode:c++
+// indent-tabs-mode:nil
+// tab-width:2
+// c-basic-offset:2
+// c-file-style:nil
+// End:
+// For VIM:
+// vim:set expandtab softtabstop=2 shiftwidth=2 tabstop=2:
@@ -0,0 +1,95 @@
+// hiptext - Image to Text Converter
+// By Justine Tunney
+
+#include "hiptext/replaycache.h"
+
+#include <chrono>
+#include <sstream>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+TEST(ReplayCacheTest, PlaysWhatWasRecorded) {
+  ReplayCache replay(1 << 10);
+  replay.Record("one", 0);
+  replay.Record("two", 0);
+  replay.Finish("one");
+  ASSERT_TRUE(replay.ok());
+  volatile bool stop = false;
+  std::ostringstream out;
+  replay.Play(out, &stop);
+  EXPECT_EQ("onetwo", out.str());
+}
+
+TEST(ReplayCacheTest, LoopsBackToTheFirstFrame) {
+  ReplayCache replay(1 << 10);
+  replay.Record("one", 0);
+  replay.Record("two", 0);
+  replay.Finish("two>one");
+  volatile bool stop = false;
+  std::ostringstream out;
+  replay.Play(out, &stop);
+  replay.Play(out, &stop);
+  EXPECT_EQ("two>onetwotwo>onetwo", out.str());
+}
+
+TEST(ReplayCacheTest, KeepsEachFramesDelay) {
+  using std::chrono::milliseconds;
+  ReplayCache replay(1 << 10);
+  replay.Record("one", 0.1);
+  replay.Record("two", 0.05);
+  replay.Finish("one");
+  volatile bool stop = false;
+  std::ostringstream out;
+  auto start = std::chrono::steady_clock::now();
+  replay.Play(out, &stop);
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  EXPECT_EQ("onetwo", out.str());
+  EXPECT_GE(elapsed, milliseconds(150));
+  EXPECT_LT(elapsed, milliseconds(400));
+}
+
+TEST(ReplayCacheTest, OverBudget) {
+  ReplayCache replay(4);
+  replay.Record("one", 0);
+  replay.Record("two", 0);
+  EXPECT_FALSE(replay.recording());
+  EXPECT_FALSE(replay.ok());
+
+  ReplayCache loop(6);
+  loop.Record("one", 0);
+  loop.Record("two", 0);
+  loop.Finish("two>one");
+  EXPECT_FALSE(loop.ok());
+}
+
+TEST(ReplayCacheTest, StopsDuringLongFrames) {
+  using std::chrono::milliseconds;
+  ReplayCache replay(1 << 10);
+  replay.Record("one", 0.5);
+  replay.Record("two", 0);
+  replay.Finish("one");
+  volatile bool stop = false;
+  std::thread stopper([&stop] {
+    std::this_thread::sleep_for(milliseconds(50));
+    stop = true;
+  });
+  std::ostringstream out;
+  auto start = std::chrono::steady_clock::now();
+  replay.Play(out, &stop);
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  stopper.join();
+  EXPECT_EQ("one", out.str());
+  EXPECT_LT(elapsed, milliseconds(250));
+}
+
+// For Emacs:
+// Local Variables:
+// mode:c++
+// indent-tabs-mode:nil
+// tab-width:2
+// c-basic-offset:2
+// c-file-style:nil
+// End:
+// For VIM:
+// vim:set expandtab softtabstop=2 shiftwidth=2 tabstop=2:
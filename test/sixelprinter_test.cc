@@ -0,0 +1,113 @@
+// hiptext - Image to Text Converter
+// By Justine Tunney
+
+#include "hiptext/sixelprinter.h"
+
+#include <bitset>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+
+#include "testutil.h"
+
+DECLARE_int32(threads);
+
+TEST(SixelPrinterTest, RoundTrip) {
+  const int width = 37;
+  const int height = 20;
+  std::mt19937 rng(1);
+  std::vector<uint8_t> codes(width * height);
+  for (int n = 0; n < width * height; ++n) {
+    // Mostly runs, with a handful of colors per band.
+    codes[n] = (n > 0 && rng() % 4) ? codes[n - 1] : rng() % 8 * 30;
+  }
+  std::ostringstream os;
+  SixelPrinter out(os, 256, false, true, 0);
+  out.Start();
+  out.PrintBands(codes.data(), width, height);
+  out.End();
+  std::vector<int> image = DecodeSixel(os.str(), width, height);
+  for (int n = 0; n < width * height; ++n) {
+    ASSERT_EQ(codes[n], image[n]) << n;
+  }
+}
+
+TEST(SixelPrinterTest, ParallelMatchesSerial) {
+  const int width = 300;
+  const int height = 200;
+  std::mt19937 rng(2);
+  std::vector<uint8_t> codes(width * height);
+  for (int n = 0; n < width * height; ++n) {
+    codes[n] = (n > 0 && rng() % 8) ? codes[n - 1] : rng() % 256;
+  }
+  std::string output[2];
+  for (int pass = 0; pass < 2; ++pass) {
+    FLAGS_threads = pass ? 4 : 1;
+    std::ostringstream os;
+    SixelPrinter out(os, 256, false, true, 0);
+    out.Start();
+    out.PrintBands(codes.data(), width, height);
+    out.End();
+    output[pass] = os.str();
+  }
+  FLAGS_threads = 0;
+  EXPECT_EQ(output[0], output[1]);
+}
+
+TEST(SixelPrinterTest, SkipsBackground) {
+  const int width = 100;
+  std::vector<uint8_t> codes(width * 6, 7);
+  codes[3 * width + 50] = 9;
+  std::ostringstream os;
+  SixelPrinter out(os, 256, false, false, 7);
+  out.Start();
+  out.PrintBands(codes.data(), width, 6);
+  out.End();
+  std::vector<int> image = DecodeSixel(os.str(), width, 6);
+  for (int n = 0; n < width * 6; ++n) {
+    ASSERT_EQ(n == 3 * width + 50 ? 9 : -1, image[n]) << n;
+  }
+  EXPECT_EQ(std::string::npos, os.str().find("#7"));
+}
+
+TEST(SixelPrinterTest, OverlayWithStrideAndKnownRegisters) {
+  // Print the middle two columns of a 4x2 image.
+  std::vector<uint8_t> codes = {1, 2, 2, 1,
+                                1, 2, 3, 1};
+  std::ostringstream os;
+  SixelPrinter out(os, 256, false, true, 0);
+  std::bitset<256> defined;
+  defined.set(2);
+  out.set_defined(defined);
+  out.Start(true);
+  out.PrintBands(&codes[1], 2, 2, 4);
+  out.End();
+  EXPECT_EQ("\x1bP0;1;8q\"1;1#3;2;80;80;0#2B@$#3?A-\x1b\\", os.str());
+  EXPECT_TRUE(out.defined()[3]);
+  EXPECT_FALSE(out.defined()[1]);
+}
+
+TEST(SixelPrinterTest, Monochrome) {
+  std::vector<uint8_t> codes = {0, 1, 1, 0, 1, 0, 0, 0};
+  std::ostringstream os;
+  SixelPrinter out(os, 2, false, false, 0);
+  out.Start();
+  out.PrintBands(codes.data(), 4, 2);
+  out.End();
+  EXPECT_EQ("\x1bP0;0;8q\"1;1A@@-\x1b\\", os.str());
+}
+
+// For Emacs:
+// Local Variables:
+// mode:c++
+// indent-tabs-mode:nil
+// tab-width:2
+// c-basic-offset:2
+// c-file-style:nil
+// End:
+// For VIM:
+// vim:set expandtab softtabstop=2 shiftwidth=2 tabstop=2:
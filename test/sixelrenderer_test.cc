@@ -0,0 +1,81 @@
+// hiptext - Image to Text Converter
+// By Justine Tunney
+
+#include "hiptext/sixelrenderer.h"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+
+#include "hiptext/artiste.h"
+#include "hiptext/graphic.h"
+#include "hiptext/pixel.h"
+
+#include "testutil.h"
+
+DECLARE_bool(sixel_adaptive);
+
+static int Count(const std::string& haystack, const std::string& needle) {
+  int res = 0;
+  for (size_t pos = 0;
+       (pos = haystack.find(needle, pos)) != std::string::npos;
+       pos += needle.size()) {
+    ++res;
+  }
+  return res;
+}
+
+TEST(SixelRendererTest, VideoResendsOnlyChangedCells) {
+  // Four by four cells, each four pixels wide and one band tall.
+  const int kCellWidth = 4;
+  const int kCellHeight = 6;
+  const int kCells = 4;
+  FLAGS_sixel_adaptive = false;
+  SetCellSize(kCellWidth, kCellHeight);
+  SetPlayingVideo(true);
+  SixelRenderer renderer(256);
+  Graphic frame(kCells * kCellWidth, kCells * kCellHeight, Pixel::kWhite);
+  std::ostringstream first;
+  renderer(first, frame);
+  EXPECT_EQ(1, Count(first.str(), "\x1bP"));
+
+  // Change a few pixels in the third row of cells, inside its second cell.
+  for (int y = 2 * kCellHeight + 1; y < 2 * kCellHeight + 4; ++y) {
+    frame.Get(kCellWidth + 1, y) = Pixel(255, 0, 0);
+  }
+  std::ostringstream second;
+  renderer(second, frame);
+  SetPlayingVideo(false);
+  SetCellSize(0, 0);
+  FLAGS_sixel_adaptive = true;
+
+  // One patch, after moving the cursor to that cell.
+  const std::string out = second.str();
+  EXPECT_EQ(0u, out.find("\x1b[3;2H\x1bP")) << out;
+  EXPECT_EQ(1, Count(out, "\x1bP"));
+  EXPECT_EQ(1, Count(out, "\x1b["));
+  // It covers just the one cell, every pixel of it.
+  const int width = kCellWidth * 2;
+  const int height = kCellHeight * 2;
+  std::vector<int> image = DecodeSixel(out, width, height);
+  for (int y = 0; y < height; ++y) {
+    for (int x = 0; x < width; ++x) {
+      EXPECT_EQ(x < kCellWidth && y < kCellHeight, image[y * width + x] >= 0)
+          << x << "," << y;
+    }
+  }
+}
+
+// For Emacs:
+// Local Variables:
+// mode:c++
+// indent-tabs-mode:nil
+// tab-width:2
+// c-basic-offset:2
+// c-file-style:nil
+// End:
+// For VIM:
+// vim:set expandtab softtabstop=2 shiftwidth=2 tabstop=2:
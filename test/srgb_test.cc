@@ -0,0 +1,45 @@
+// hiptext - Image to Text Converter
+// By Justine Tunney
+
+#include "hiptext/srgb.h"
+
+#include <gtest/gtest.h>
+
+#include "hiptext/pixel.h"
+
+TEST(SrgbTest, KnownValues) {
+  EXPECT_EQ(0.0f, SrgbToLinear(0));
+  EXPECT_EQ(1.0f, SrgbToLinear(255));
+  EXPECT_NEAR(0.2158, SrgbToLinear(128), 1e-4);
+  EXPECT_EQ(0, LinearToSrgb(0.0));
+  EXPECT_EQ(255, LinearToSrgb(1.0));
+  // Half as much light is much brighter than half way on the code scale.
+  EXPECT_EQ(188, LinearToSrgb(0.5));
+  EXPECT_EQ(0, LinearToSrgb(-1.0));
+  EXPECT_EQ(255, LinearToSrgb(2.0));
+}
+
+TEST(SrgbTest, RoundTrip) {
+  for (int code = 0; code < 256; ++code) {
+    EXPECT_EQ(code, LinearToSrgb(SrgbToLinear(code))) << code;
+  }
+}
+
+TEST(SrgbTest, Pixel) {
+  Pixel pix(10, 128, 250, 100);
+  Pixel linear = pix.Copy().ToLinear();
+  EXPECT_NEAR(SrgbToLinear(128), linear.green(), 1e-9);
+  EXPECT_EQ(pix.alpha(), linear.alpha());
+  EXPECT_EQ(pix, linear.FromLinear());
+}
+
+// For Emacs:
+// Local Variables:
+// mode:c++
+// indent-tabs-mode:nil
+// tab-width:2
+// c-basic-offset:2
+// c-file-style:nil
+// End:
+// For VIM:
+// vim:set expandtab softtabstop=2 shiftwidth=2 tabstop=2:
@@ -0,0 +1,91 @@
+// hiptext - Image to Text Converter
+// By Justine Tunney
+
+#include "hiptext/subcell.h"
+
+#include <gtest/gtest.h>
+
+#include "hiptext/pixel.h"
+
+TEST(SubcellTest, QuadrantGlyph) {
+  EXPECT_EQ(L' ', QuadrantGlyph(0));
+  EXPECT_EQ(L'▘', QuadrantGlyph(1));   // Upper left.
+  EXPECT_EQ(L'▀', QuadrantGlyph(3));   // Upper half.
+  EXPECT_EQ(L'▌', QuadrantGlyph(5));   // Left half.
+  EXPECT_EQ(L'▚', QuadrantGlyph(9));   // Upper left and lower right.
+  EXPECT_EQ(L'█', QuadrantGlyph(15));
+}
+
+TEST(SubcellTest, SextantGlyph) {
+  EXPECT_EQ(L' ', SextantGlyph(0));
+  EXPECT_EQ(static_cast<wchar_t>(0x1fb00), SextantGlyph(1));
+  EXPECT_EQ(static_cast<wchar_t>(0x1fb13), SextantGlyph(20));
+  EXPECT_EQ(L'▌', SextantGlyph(21));
+  EXPECT_EQ(static_cast<wchar_t>(0x1fb14), SextantGlyph(22));
+  EXPECT_EQ(static_cast<wchar_t>(0x1fb27), SextantGlyph(41));
+  EXPECT_EQ(L'▐', SextantGlyph(42));
+  EXPECT_EQ(static_cast<wchar_t>(0x1fb28), SextantGlyph(43));
+  EXPECT_EQ(static_cast<wchar_t>(0x1fb3b), SextantGlyph(62));
+  EXPECT_EQ(L'█', SextantGlyph(63));
+}
+
+TEST(SubcellTest, BrailleGlyph) {
+  EXPECT_EQ(L'⠀', BrailleGlyph(0));
+  EXPECT_EQ(L'⠁', BrailleGlyph(1 << 0));  // Dot 1, top left.
+  EXPECT_EQ(L'⠈', BrailleGlyph(1 << 1));  // Dot 4, top right.
+  EXPECT_EQ(L'⠂', BrailleGlyph(1 << 2));  // Dot 2.
+  EXPECT_EQ(L'⡀', BrailleGlyph(1 << 6));  // Dot 7, bottom left.
+  EXPECT_EQ(L'⢀', BrailleGlyph(1 << 7));  // Dot 8, bottom right.
+  EXPECT_EQ(L'⣿', BrailleGlyph(255));
+}
+
+TEST(SubcellTest, FitSplitsTwoColors) {
+  const Pixel red(200, 10, 10);
+  const Pixel blue(10, 10, 180);
+  Pixel pixels[6] = {red, blue, blue, red, red, red};
+  Pixel fg;
+  Pixel bg;
+  int mask = FitCell(pixels, 6, &fg, &bg);
+  // The first cluster is whichever is higher on the widest channel.
+  EXPECT_EQ(0x39, mask);
+  EXPECT_NEAR(red.red(), fg.red(), 1e-9);
+  EXPECT_NEAR(blue.blue(), bg.blue(), 1e-9);
+}
+
+TEST(SubcellTest, FitRefinesSplit) {
+  // Cutting red down the middle puts 130 with the bright pixels, but it's
+  // much closer to the dark ones on average.
+  static const int kReds[8] = {0, 120, 120, 120, 130, 255, 255, 255};
+  Pixel pixels[8];
+  for (int n = 0; n < 8; ++n) {
+    pixels[n] = Pixel(kReds[n], 0, 0);
+  }
+  Pixel fg;
+  Pixel bg;
+  EXPECT_EQ(0xe0, FitCell(pixels, 8, &fg, &bg));
+  EXPECT_NEAR(1.0, fg.red(), 1e-9);
+  EXPECT_NEAR(98.0 / 255.0, bg.red(), 1e-9);
+}
+
+TEST(SubcellTest, FitUniform) {
+  Pixel pixels[8];
+  for (Pixel& pix : pixels) {
+    pix = Pixel(30, 60, 90);
+  }
+  Pixel fg;
+  Pixel bg;
+  EXPECT_EQ(0, FitCell(pixels, 8, &fg, &bg));
+  EXPECT_NEAR(60.0 / 255.0, bg.green(), 1e-9);
+  EXPECT_NEAR(bg.green(), fg.green(), 1e-9);
+}
+
+// For Emacs:
+// Local Variables:
+// mode:c++
+// indent-tabs-mode:nil
+// tab-width:2
+// c-basic-offset:2
+// c-file-style:nil
+// End:
+// For VIM:
+// vim:set expandtab softtabstop=2 shiftwidth=2 tabstop=2:
@@ -0,0 +1,97 @@
+// hiptext - Image to Text Converter
+// By Justine Tunney
+
+#include "hiptext/summedarea.h"
+
+#include <gtest/gtest.h>
+
+#include "hiptext/graphic.h"
+#include "hiptext/pixel.h"
+
+// Each pixel's channels depend on where it is, so every rectangle differs.
+static Graphic MakeGradient(int width, int height) {
+  Graphic graphic(width, height);
+  for (int y = 0; y < height; ++y) {
+    for (int x = 0; x < width; ++x) {
+      graphic.Get(x, y) = Pixel(x * 20, y * 30, (x * y * 7) % 256);
+    }
+  }
+  return graphic;
+}
+
+TEST(SummedAreaTableTest, MeanMatchesAverageColor) {
+  Graphic graphic = MakeGradient(7, 5);
+  SummedAreaTable table(graphic);
+  EXPECT_EQ(7, table.width());
+  EXPECT_EQ(5, table.height());
+  const int kRects[][4] = {
+    {0, 0, 7, 5}, {0, 0, 1, 1}, {6, 4, 1, 1}, {2, 1, 3, 4}, {1, 3, 6, 2},
+  };
+  for (const auto& rect : kRects) {
+    Pixel slow = graphic.GetAverageColor(rect[0], rect[1], rect[2], rect[3]);
+    Pixel fast = table.Mean(rect[0], rect[1], rect[2], rect[3]);
+    EXPECT_NEAR(slow.red(), fast.red(), 1e-4);
+    EXPECT_NEAR(slow.green(), fast.green(), 1e-4);
+    EXPECT_NEAR(slow.blue(), fast.blue(), 1e-4);
+    EXPECT_NEAR(1.0, fast.alpha(), 1e-9);
+  }
+}
+
+TEST(SummedAreaTableTest, Variance) {
+  Graphic graphic(2, 2, Pixel::kBlack);
+  graphic.Get(1, 0) = Pixel::kWhite;
+  graphic.Get(1, 1) = Pixel::kWhite;
+  SummedAreaTable table(graphic, true);
+  // Half black and half white varies by a quarter in each channel.
+  EXPECT_NEAR(0.75, table.Variance(0, 0, 2, 2), 1e-9);
+  EXPECT_NEAR(0.0, table.Variance(1, 0, 1, 2), 1e-9);
+  EXPECT_NEAR(0.0, table.Variance(0, 1, 1, 1), 1e-9);
+}
+
+TEST(SummedAreaTableTest, AreaScale) {
+  // Alternating columns, which bilinear scaling would alias.
+  Graphic graphic(8, 4, Pixel::kBlack);
+  for (int y = 0; y < 4; ++y) {
+    for (int x = 1; x < 8; x += 2) {
+      graphic.Get(x, y) = Pixel::kWhite;
+    }
+  }
+  Graphic small = AreaScale(graphic, 3, 2);
+  ASSERT_EQ(3, small.width());
+  ASSERT_EQ(2, small.height());
+  // Columns split 0-1, 2-4 and 5-7.
+  EXPECT_NEAR(0.5, small.Get(0, 0).red(), 1e-4);
+  EXPECT_NEAR(1.0 / 3.0, small.Get(1, 1).green(), 1e-4);
+  EXPECT_NEAR(2.0 / 3.0, small.Get(2, 0).blue(), 1e-4);
+}
+
+TEST(SummedAreaTableTest, AreaScaleMatchesTable) {
+  Graphic graphic = MakeGradient(12, 8);
+  SummedAreaTable table(graphic);
+  const int kSizes[][2] = {{5, 3}, {12, 5}, {1, 1}, {20, 15}};
+  for (const auto& size : kSizes) {
+    Graphic direct = AreaScale(graphic, size[0], size[1]);
+    Graphic tabled = AreaScale(table, size[0], size[1]);
+    ASSERT_EQ(tabled.width(), direct.width());
+    ASSERT_EQ(tabled.height(), direct.height());
+    for (int y = 0; y < direct.height(); ++y) {
+      for (int x = 0; x < direct.width(); ++x) {
+        EXPECT_NEAR(tabled.Get(x, y).red(), direct.Get(x, y).red(), 1e-4);
+        EXPECT_NEAR(tabled.Get(x, y).green(), direct.Get(x, y).green(), 1e-4);
+        EXPECT_NEAR(tabled.Get(x, y).blue(), direct.Get(x, y).blue(), 1e-4);
+        EXPECT_NEAR(tabled.Get(x, y).alpha(), direct.Get(x, y).alpha(), 1e-4);
+      }
+    }
+  }
+}
+
+// For Emacs:
+// Local Variables:
+// mode:c++
+// indent-tabs-mode:nil
+// tab-width:2
+// c-basic-offset:2
+// c-file-style:nil
+// End:
+// For VIM:
+// vim:set expandtab softtabstop=2 shiftwidth=2 tabstop=2:
@@ -0,0 +1,65 @@
+// hiptext - Image to Text Converter
+// By Justine Tunney
+
+#include "hiptext/termpalette.h"
+
+#include <sstream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "hiptext/pixel.h"
+#include "hiptext/xterm256.h"
+
+TEST(TermPaletteTest, ParsePaletteReply) {
+  Pixel colors[256];
+  for (Pixel& color : colors) {
+    color = Pixel::kClear;
+  }
+  std::string reply =
+      "\x1b]4;1;rgb:cdcd/0000/0000\a"
+      "\x1b]4;2;rgb:0/f/8\x1b\\"
+      "\x1b]4;3;rgb:zz/00/00\a"      // Malformed.
+      "\x1b]4;300;rgb:ff/ff/ff\a"    // Out of range.
+      "\x1b[?64;1;2c";
+  EXPECT_EQ(2, ParsePaletteReply(reply, colors));
+  EXPECT_EQ(Pixel(205, 0, 0), colors[1]);
+  EXPECT_DOUBLE_EQ(0.0, colors[2].red());
+  EXPECT_DOUBLE_EQ(1.0, colors[2].green());
+  EXPECT_DOUBLE_EQ(8.0 / 15.0, colors[2].blue());
+  EXPECT_EQ(Pixel::kClear, colors[3]);
+}
+
+TEST(TermPaletteTest, SaveAndLoadXtermColors) {
+  Pixel original[256];
+  Pixel colors[256];
+  for (int n = 0; n < 256; ++n) {
+    original[n] = g_xterm[n];
+    colors[n] = Pixel(255 - n, n, n / 2);
+  }
+  SetXtermColors(colors);
+  std::stringstream saved;
+  SaveXtermColors(saved);
+  uint8_t expected = rgb_to_xterm256(Pixel(100, 150, 75));
+  SetXtermColors(original);
+  EXPECT_TRUE(LoadXtermColors(saved));
+  EXPECT_EQ(colors[77], g_xterm[77]);
+  EXPECT_EQ(expected, rgb_to_xterm256(Pixel(100, 150, 75)));
+  EXPECT_EQ(rgb_to_xterm(Pixel(100, 150, 75), 16, 256),
+            rgb_to_xterm256(Pixel(100, 150, 75)));
+
+  std::stringstream truncated(saved.str().substr(0, 1000));
+  EXPECT_FALSE(LoadXtermColors(truncated));
+  SetXtermColors(original);
+}
+
+// For Emacs:
+// Local Variables:
+// mode:c++
+// indent-tabs-mode:nil
+// tab-width:2
+// c-basic-offset:2
+// c-file-style:nil
+// End:
+// For VIM:
+// vim:set expandtab softtabstop=2 shiftwidth=2 tabstop=2:
@@ -0,0 +1,73 @@
+// hiptext - Image to Text Converter
+// By Justine Tunney
+
+#include "hiptext/termprinter.h"
+
+#include <sstream>
+
+#include <gtest/gtest.h>
+
+TEST(TermPrinterTest, ForegroundRGB) {
+  std::ostringstream out;
+  TermPrinter printer(out);
+  printer.SetForegroundRGB(1, 2, 3);
+  printer << "x";
+  EXPECT_EQ("\x1b[38;2;1;2;3mx", out.str());
+}
+
+TEST(TermPrinterTest, BackgroundRGB) {
+  std::ostringstream out;
+  TermPrinter printer(out);
+  printer.SetBackgroundRGB(255, 0, 128);
+  printer << "x";
+  EXPECT_EQ("\x1b[48;2;255;0;128mx", out.str());
+}
+
+TEST(TermPrinterTest, BlackIsStillAColor) {
+  // Zero channels are printed, and black isn't mistaken for no color.
+  std::ostringstream out;
+  TermPrinter printer(out);
+  printer.SetForegroundRGB(0, 0, 0);
+  printer.SetBackgroundRGB(0, 0, 0);
+  printer << "x";
+  EXPECT_EQ("\x1b[38;2;0;0;0;48;2;0;0;0mx", out.str());
+}
+
+TEST(TermPrinterTest, RepeatedColorsAreSkipped) {
+  std::ostringstream out;
+  TermPrinter printer(out);
+  printer.SetForegroundRGB(10, 20, 30);
+  printer.SetBackgroundRGB(40, 50, 60);
+  printer << "a";
+  printer.SetForegroundRGB(10, 20, 30);
+  printer.SetBackgroundRGB(40, 50, 60);
+  printer << "b";
+  printer.SetForegroundRGB(10, 20, 31);
+  printer.SetBackgroundRGB(40, 50, 60);
+  printer << "c";
+  EXPECT_EQ("\x1b[38;2;10;20;30;48;2;40;50;60mab\x1b[38;2;10;20;31mc",
+            out.str());
+}
+
+TEST(TermPrinterTest, SwitchesBetweenRGBAnd256) {
+  std::ostringstream out;
+  TermPrinter printer(out);
+  printer.SetForegroundRGB(1, 2, 3);
+  printer << "a";
+  printer.SetForeground256(196);
+  printer << "b";
+  printer.SetForegroundRGB(1, 2, 3);
+  printer << "c";
+  EXPECT_EQ("\x1b[38;2;1;2;3ma\x1b[38;5;196mb\x1b[38;2;1;2;3mc", out.str());
+}
+
+// For Emacs:
+// Local Variables:
+// mode:c++
+// indent-tabs-mode:nil
+// tab-width:2
+// c-basic-offset:2
+// c-file-style:nil
+// End:
+// For VIM:
+// vim:set expandtab softtabstop=2 shiftwidth=2 tabstop=2:
@@ -0,0 +1,92 @@
+// hiptext - Image to Text Converter
+// By Justine Tunney
+
+#include "hiptext/termraster.h"
+
+#include <gtest/gtest.h>
+
+#include "hiptext/font.h"
+#include "hiptext/graphic.h"
+#include "hiptext/pixel.h"
+#include "hiptext/xterm256.h"
+
+#include "testutil.h"
+
+TEST(TermGridTest, Colors256) {
+  TermGrid grid;
+  grid.Write("\x1b[38;5;196;48;5;21mab\x1b[0m\nc\n");
+  EXPECT_EQ(2, grid.width());
+  EXPECT_EQ(2, grid.height());
+  EXPECT_EQ(L'b', grid.Get(1, 0).glyph);
+  EXPECT_EQ(196, grid.Get(1, 0).fg);
+  EXPECT_EQ(21, grid.Get(1, 0).bg);
+  EXPECT_EQ(L'c', grid.Get(0, 1).glyph);
+  EXPECT_EQ(kDefaultColor, grid.Get(0, 1).fg);
+  EXPECT_EQ(kDefaultColor, grid.Get(0, 1).bg);
+  EXPECT_EQ(L' ', grid.Get(1, 1).glyph);  // Never drawn.
+}
+
+TEST(TermGridTest, TrueColorAndUnicode) {
+  TermGrid grid;
+  grid.Write("\x1b[48;2;1;2;3m\xe2\x96\x80\x1b[7m\xf0\x9f\xac\x80");
+  EXPECT_EQ(L'▀', grid.Get(0, 0).glyph);
+  EXPECT_EQ(kRGBColor | 0x010203, grid.Get(0, 0).bg);
+  EXPECT_EQ(static_cast<wchar_t>(0x1fb00), grid.Get(1, 0).glyph);
+  EXPECT_EQ(kRGBColor | 0x010203, grid.Get(1, 0).fg);  // Flipped.
+  EXPECT_EQ(kDefaultColor, grid.Get(1, 0).bg);
+}
+
+TEST(TermGridTest, CursorAndControlStrings) {
+  TermGrid grid;
+  grid.Write("xx\x1b[H\x1bPq#0;2;0;0;0#0~\x1b\\y\x1b[2;3Hz\r\x1b[?25lw");
+  EXPECT_EQ(L'y', grid.Get(0, 0).glyph);
+  EXPECT_EQ(L'x', grid.Get(1, 0).glyph);
+  EXPECT_EQ(L'w', grid.Get(0, 1).glyph);
+  EXPECT_EQ(L'z', grid.Get(2, 1).glyph);
+  EXPECT_EQ(3, grid.width());
+}
+
+TEST(RasterizeTerminalTest, Blocks) {
+  ASSERT_TRUE(HaveFont());
+  TermGrid grid;
+  grid.Write("\x1b[38;5;196;48;5;21m\xe2\x96\x80\x1b[0m \n");
+  Graphic graphic = RasterizeTerminal(grid);
+  const Glyph& em = GetGlyphAtlas().Get(L'M');
+  ASSERT_EQ(em.width * 2, graphic.width());
+  ASSERT_EQ(em.height, graphic.height());
+  // The upper half block fills exactly the top of its cell.
+  EXPECT_EQ(g_xterm[196], graphic.Get(0, 0));
+  EXPECT_EQ(g_xterm[196], graphic.Get(em.width - 1, (em.height - 1) / 2));
+  EXPECT_EQ(g_xterm[21], graphic.Get(0, (em.height + 1) / 2));
+  EXPECT_EQ(g_xterm[21], graphic.Get(em.width - 1, em.height - 1));
+  // Blank cells are the --bg color.
+  EXPECT_EQ(Pixel::kBlack, graphic.Get(em.width, 0));
+}
+
+TEST(RasterizeTerminalTest, Letters) {
+  ASSERT_TRUE(HaveFont());
+  TermGrid grid;
+  grid.Write("\x1b[38;2;255;255;255mM");
+  Graphic graphic = RasterizeTerminal(grid);
+  int inked = 0;
+  for (int y = 0; y < graphic.height(); ++y) {
+    for (int x = 0; x < graphic.width(); ++x) {
+      if (graphic.Get(x, y).grey() > 0.5) {
+        ++inked;
+      }
+    }
+  }
+  EXPECT_GT(inked, 0);
+  EXPECT_LT(inked, graphic.width() * graphic.height() / 2);
+}
+
+// For Emacs:
+// Local Variables:
+// mode:c++
+// indent-tabs-mode:nil
+// tab-width:2
+// c-basic-offset:2
+// c-file-style:nil
+// End:
+// For VIM:
+// vim:set expandtab softtabstop=2 shiftwidth=2 tabstop=2:
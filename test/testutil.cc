@@ -0,0 +1,86 @@
+// hiptext - Image to Text Converter
+// By Justine Tunney
+
+#include "testutil.h"
+
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+
+#include "hiptext/font.h"
+
+DECLARE_string(font);
+
+bool HaveFont() {
+  static const bool loaded = [] {
+    FILE* fp = fopen(FLAGS_font.c_str(), "rb");
+    if (!fp) {
+      PLOG(ERROR) << "can't load font for tests: " << FLAGS_font;
+      return false;
+    }
+    fclose(fp);
+    InitFont();
+    return true;
+  }();
+  return loaded;
+}
+
+std::vector<int> DecodeSixel(const std::string& data, int width, int height) {
+  std::vector<int> image(width * height, -1);
+  size_t start = data.find('q');
+  EXPECT_NE(std::string::npos, start);
+  const char* p = data.c_str() + start + 1;
+  int x = 0;
+  int band = 0;
+  int color = 0;
+  while (*p && *p != '\x1b') {
+    int repeat = 1;
+    if (*p == '"') {  // Raster attributes.
+      for (++p; isdigit(*p) || *p == ';'; ++p) {}
+      continue;
+    } else if (*p == '#') {
+      color = strtol(p + 1, const_cast<char**>(&p), 10);
+      while (*p == ';') {  // Color definition.
+        strtol(p + 1, const_cast<char**>(&p), 10);
+      }
+      continue;
+    } else if (*p == '$') {
+      x = 0;
+      ++p;
+      continue;
+    } else if (*p == '-') {
+      x = 0;
+      ++band;
+      ++p;
+      continue;
+    } else if (*p == '!') {
+      repeat = strtol(p + 1, const_cast<char**>(&p), 10);
+    }
+    int bits = *p++ - 0x3f;
+    EXPECT_TRUE(0 <= bits && bits < 64);
+    for (; repeat--; ++x) {
+      for (int row = 0; row < 6; ++row) {
+        int y = band * 6 + row;
+        if ((bits & (1 << row)) && y < height && x < width) {
+          image[y * width + x] = color;
+        }
+      }
+    }
+  }
+  return image;
+}
+
+// For Emacs:
+// Local Variables:
+// mode:c++
+// indent-tabs-mode:nil
+// tab-width:2
+// c-basic-offset:2
+// c-file-style:nil
+// End:
+// For VIM:
+// vim:set expandtab softtabstop=2 shiftwidth=2 tabstop=2:
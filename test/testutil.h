@@ -0,0 +1,31 @@
+// hiptext - Image to Text Converter
+// By Justine Tunney
+
+#ifndef HIPTEXT_TESTUTIL_H_
+#define HIPTEXT_TESTUTIL_H_
+
+#include <string>
+#include <vector>
+
+// Loads the font the first time it's called, for tests that draw text.
+// Returns false, after logging why, if it isn't where --font says, which is
+// the top of the source tree by default. Tests should fail rather than pass
+// without having run, e.g. with ASSERT_TRUE(HaveFont()).
+bool HaveFont();
+
+// Paints SIXEL data into a 'width' by 'height' image of register numbers,
+// where -1 means the pixel was never drawn.
+std::vector<int> DecodeSixel(const std::string& data, int width, int height);
+
+#endif  // HIPTEXT_TESTUTIL_H_
+
+// For Emacs:
+// Local Variables:
+// mode:c++
+// indent-tabs-mode:nil
+// tab-width:2
+// c-basic-offset:2
+// c-file-style:nil
+// End:
+// For VIM:
+// vim:set expandtab softtabstop=2 shiftwidth=2 tabstop=2: